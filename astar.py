@@ -1,5 +1,6 @@
 import math
 import heapq
+import numpy as np
 import pathfinder  # Our C++ module
 import cv2
 
@@ -192,6 +193,31 @@ def draw_path_on_image(image_path, original_path, optimized_path=None, output_pa
     cv2.imwrite(output_path, img)
     print(f"Saved result to {output_path}")
 
+def draw_search_heatmap(image_path, expansions, los_checks=None, output_path="search_heatmap.png"):
+    """Overlay per-cell search counts from pathfinder.find_path_traced on the map image.
+    
+    Expansions are drawn in red and line-of-sight trace visits in green, each on a log scale,
+    so hot spots from a poor heuristic or map layout stand out.
+    """
+    img = cv2.imread(image_path)
+    if img is None:
+        raise FileNotFoundError(f"Could not read image at {image_path}")
+    
+    def log_scale(counts):
+        counts = np.log1p(np.asarray(counts, dtype=np.float32))
+        peak = counts.max()
+        return counts / peak if peak > 0 else counts
+    
+    overlay = img.astype(np.float32)
+    heat = log_scale(expansions)
+    overlay[:, :, 2] = overlay[:, :, 2] * (1 - heat) + 255 * heat
+    if los_checks is not None:
+        trace = log_scale(los_checks)
+        overlay[:, :, 1] = overlay[:, :, 1] * (1 - trace) + 255 * trace
+    
+    cv2.imwrite(output_path, overlay.astype(np.uint8))
+    print(f"Saved search heatmap to {output_path}")
+
 if __name__ == "__main__":
     # Load grid from cost_map.png
     try:
@@ -224,8 +250,7 @@ if __name__ == "__main__":
     if path:
         print("Optimizing path")
         final_path = multi_pass_optimize(grid, path)
-        with open('path.txt','w') as f:
-            f.write(str(final_path))
+        pathfinder.write_path_file('path.wpts', np.array(final_path, dtype=np.int32).reshape(-1, 2))
         # Visualize both paths if using image input
         if input_image:
             draw_path_on_image(input_image, path, final_path, "thetastar_comparison.png")
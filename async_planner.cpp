@@ -0,0 +1,166 @@
+#include "async_planner.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <stdexcept>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+bool PlanFuture::done() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return done_;
+}
+
+void PlanFuture::wait() const {
+    std::unique_lock<std::mutex> lock(mutex_);
+    ready_.wait(lock, [&] { return done_; });
+}
+
+const PathFinder::Path& PlanFuture::get() const {
+    wait();
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (error_) {
+        std::rethrow_exception(error_);
+    }
+    return path_;
+}
+
+bool PlanFuture::waitFor(double seconds) const {
+    std::unique_lock<std::mutex> lock(mutex_);
+    return ready_.wait_for(lock, std::chrono::duration<double>(std::max(seconds, 0.0)), [&] { return done_; });
+}
+
+PathFinder::SearchStats PlanFuture::stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+void PlanFuture::finish(PathFinder::Path&& path, const PathFinder::SearchStats& stats, std::exception_ptr error) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        path_ = std::move(path);
+        stats_ = stats;
+        error_ = error;
+        done_ = true;
+    }
+    ready_.notify_all();
+}
+
+AsyncPlanner::AsyncPlanner(std::shared_ptr<const PathFinder::Grid> grid, size_t threads) : grid_(std::move(grid)) {
+    wakeup_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (wakeup_fd_ < 0) {
+        throw std::runtime_error(std::string("Cannot create wakeup eventfd: ") + std::strerror(errno));
+    }
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    running_.resize(threads);
+    workers_.reserve(threads);
+    for (size_t i = 0; i < threads; i++) {
+        workers_.emplace_back(&AsyncPlanner::workerLoop, this, i);
+    }
+}
+
+AsyncPlanner::~AsyncPlanner() {
+    std::deque<Job> abandoned;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+        abandoned.swap(jobs_);
+        // Cancelling a query that already finished is harmless
+        for (const std::shared_ptr<PlanFuture>& future : running_) {
+            if (future) {
+                future->cancel();
+            }
+        }
+    }
+    work_.notify_all();
+    for (std::thread& worker : workers_) {
+        worker.join();
+    }
+    const auto error = std::make_exception_ptr(std::runtime_error("AsyncPlanner shut down before the query ran"));
+    for (Job& job : abandoned) {
+        job.future->finish({}, PathFinder::SearchStats(), error);
+    }
+    close(wakeup_fd_);
+}
+
+void AsyncPlanner::setGrid(std::shared_ptr<const PathFinder::Grid> grid) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    grid_ = std::move(grid);
+}
+
+std::shared_ptr<PlanFuture> AsyncPlanner::submit(const PathFinder::Point& start, const PathFinder::Point& end,
+                                                 bool notify) {
+    std::shared_ptr<PlanFuture> future;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        future = std::make_shared<PlanFuture>(next_id_++);
+        jobs_.push_back({grid_, start, end, notify, future});
+    }
+    work_.notify_one();
+    return future;
+}
+
+std::vector<std::shared_ptr<PlanFuture>> AsyncPlanner::takeCompleted() {
+    // Reset the descriptor before taking the list: a completion landing in between signals
+    // it again, so none is left waiting without a wakeup
+    uint64_t count;
+    while (read(wakeup_fd_, &count, sizeof(count)) < 0 && errno == EINTR) {
+    }
+    std::vector<std::shared_ptr<PlanFuture>> completed;
+    std::lock_guard<std::mutex> lock(completed_mutex_);
+    completed.swap(completed_);
+    return completed;
+}
+
+size_t AsyncPlanner::pending() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return jobs_.size();
+}
+
+void AsyncPlanner::workerLoop(size_t worker) {
+    PathFinder::SearchContext context;
+    for (;;) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            work_.wait(lock, [&] { return stopping_ || !jobs_.empty(); });
+            if (stopping_) {
+                return;
+            }
+            job = std::move(jobs_.front());
+            jobs_.pop_front();
+            running_[worker] = job.future;
+        }
+
+        PathFinder::Path path;
+        PathFinder::SearchStats stats;
+        std::exception_ptr error;
+        if (job.future->token_.cancelled()) {
+            stats.cancelled = true;
+        } else {
+            try {
+                PathFinder::SearchOptions options;
+                options.context = &context;
+                options.cancel = &job.future->token_;
+                options.stats = &stats;
+                path = PathFinder::findPath(*job.grid, job.start, job.end, options);
+            } catch (...) {
+                error = std::current_exception();
+            }
+        }
+        job.future->finish(std::move(path), stats, error);
+
+        if (job.notify) {
+            {
+                std::lock_guard<std::mutex> lock(completed_mutex_);
+                completed_.push_back(job.future);
+            }
+            const uint64_t one = 1;
+            while (write(wakeup_fd_, &one, sizeof(one)) < 0 && errno == EINTR) {
+            }
+        }
+    }
+}
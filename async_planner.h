@@ -0,0 +1,109 @@
+#ifndef ASYNC_PLANNER_H
+#define ASYNC_PLANNER_H
+
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <memory>
+#include <exception>
+#include <cstdint>
+#include "pathfinder.h"
+
+// Result slot of one submitted query
+class PlanFuture {
+public:
+    explicit PlanFuture(uint64_t id) : id_(id) {}
+
+    uint64_t id() const { return id_; }
+    bool done() const;
+
+    void wait() const;
+
+    // Blocks until the query finishes; rethrows its error
+    const PathFinder::Path& get() const;
+
+    // False if the query is still running after `seconds`
+    bool waitFor(double seconds) const;
+
+    // Stops the query at its next cancellation check, or before it starts; it then finishes
+    // with an empty path and stats().cancelled set
+    void cancel() { token_.cancel(); }
+
+    // Counters of the search; valid once done()
+    PathFinder::SearchStats stats() const;
+
+private:
+    friend class AsyncPlanner;
+    void finish(PathFinder::Path&& path, const PathFinder::SearchStats& stats, std::exception_ptr error);
+
+    uint64_t id_;
+    PathFinder::CancellationToken token_;
+    mutable std::mutex mutex_;
+    mutable std::condition_variable ready_;
+    bool done_ = false;
+    PathFinder::Path path_;
+    PathFinder::SearchStats stats_;
+    std::exception_ptr error_;
+};
+
+// Queries planned on background threads against a shared map. submit() returns at once;
+// completions can be collected without blocking through takeCompleted(), and an eventfd
+// becomes readable whenever there are some, so an event loop can wait on it alongside its
+// sockets instead of parking one thread per query.
+class AsyncPlanner {
+public:
+    // `threads` workers, 0 for one per hardware thread
+    AsyncPlanner(std::shared_ptr<const PathFinder::Grid> grid, size_t threads = 0);
+
+    // Running queries are cancelled and queries not yet started fail with std::runtime_error,
+    // so shutdown waits for at most one expansion per worker
+    ~AsyncPlanner();
+
+    AsyncPlanner(const AsyncPlanner&) = delete;
+    AsyncPlanner& operator=(const AsyncPlanner&) = delete;
+
+    // Later submissions plan on `grid`; queries already queued keep the map they were given
+    void setGrid(std::shared_ptr<const PathFinder::Grid> grid);
+
+    // With `notify`, the finished future is also queued for takeCompleted() and the wakeup
+    // descriptor is signalled
+    std::shared_ptr<PlanFuture> submit(const PathFinder::Point& start, const PathFinder::Point& end,
+                                       bool notify = false);
+
+    // Descriptor that reads as ready while notified completions are waiting
+    int wakeupFd() const { return wakeup_fd_; }
+
+    // Notified futures that finished since the last call; clears the wakeup descriptor
+    std::vector<std::shared_ptr<PlanFuture>> takeCompleted();
+
+    size_t pending() const;
+    size_t threads() const { return workers_.size(); }
+
+private:
+    struct Job {
+        std::shared_ptr<const PathFinder::Grid> grid;
+        PathFinder::Point start, end;
+        bool notify;
+        std::shared_ptr<PlanFuture> future;
+    };
+
+    void workerLoop(size_t worker);
+
+    std::vector<std::thread> workers_;
+    int wakeup_fd_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable work_;
+    std::deque<Job> jobs_;
+    std::vector<std::shared_ptr<PlanFuture>> running_;  // last job taken by each worker
+    std::shared_ptr<const PathFinder::Grid> grid_;
+    uint64_t next_id_ = 1;
+    bool stopping_ = false;
+
+    std::mutex completed_mutex_;
+    std::vector<std::shared_ptr<PlanFuture>> completed_;
+};
+
+#endif // ASYNC_PLANNER_H
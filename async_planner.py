@@ -0,0 +1,59 @@
+import asyncio
+import pathfinder  # Our C++ module
+
+class AsyncPathPlanner:
+    def __init__(self, grid, threads=0, loop=None):
+        """Plan find_path queries on native worker threads from an asyncio event loop.
+        
+        Completions are delivered through the planner's wakeup descriptor registered with
+        loop.add_reader, so any number of queries can be in flight without an executor
+        thread per query. Without loop, construct it from a coroutine: it attaches to the
+        running loop and raises RuntimeError when there is none.
+        """
+        self._loop = loop if loop is not None else asyncio.get_running_loop()
+        self._planner = pathfinder.AsyncPlanner(grid, threads)
+        self._waiting = {}
+        self._loop.add_reader(self._planner.fileno(), self._on_wakeup)
+
+    def set_grid(self, grid):
+        """Plan later queries on grid; queries already submitted keep the previous map."""
+        self._planner.set_grid(grid)
+
+    def submit(self, start, end):
+        """Queue a query and return an asyncio Future resolving to its path."""
+        native = self._planner.submit(tuple(start), tuple(end), notify=True)
+        future = self._loop.create_future()
+        # Completions are only read on the loop thread, so registering after submit cannot race
+        self._waiting[native.id] = (native, future)
+        # A cancelled await (e.g. the robot's task was reassigned) frees the worker too
+        future.add_done_callback(lambda f: native.cancel() if f.cancelled() else None)
+        return future
+
+    async def find_path(self, start, end):
+        return await self.submit(start, end)
+
+    @property
+    def in_flight(self):
+        return len(self._waiting)
+
+    def _on_wakeup(self):
+        for native in self._planner.take_completed():
+            entry = self._waiting.pop(native.id, None)
+            if entry is None or entry[1].cancelled():
+                continue
+            try:
+                entry[1].set_result(native.result())
+            except Exception as e:
+                entry[1].set_exception(e)
+
+    def close(self):
+        """Stop the workers; futures still waiting are cancelled."""
+        if self._planner is not None:
+            self._loop.remove_reader(self._planner.fileno())
+            # Cancel natively first: the futures' done-callbacks would only run after the
+            # planner below has already waited for its workers
+            for native, future in self._waiting.values():
+                native.cancel()
+                future.cancel()
+            self._waiting.clear()
+            self._planner = None
@@ -0,0 +1,57 @@
+"""Checks whether interleaving searches on one core (PathFinder::findPathsInterleaved) beats
+running them one at a time (find_paths with a single thread) on this machine and map size.
+
+So far it has not: every lane count measured slower than the sequential run, so the module
+does not export it. To re-check, make it public and bind it as
+find_paths_interleaved(grid, queries, lanes) in a local build, then run this; export it only
+once some configuration comes out faster.
+"""
+import sys
+import time
+import numpy as np
+import pathfinder  # Our C++ module
+
+def random_grid(size, obstacle_ratio=0.15, seed=0):
+    rng = np.random.default_rng(seed)
+    return (rng.random((size, size)) < obstacle_ratio).astype(np.int32).tolist()
+
+def random_queries(grid, count, reach=200, seed=1):
+    """(start, end) pairs of free cells up to reach cells apart along each axis."""
+    rng = np.random.default_rng(seed)
+    size = len(grid)
+    queries = []
+    while len(queries) < count:
+        start = tuple(int(v) for v in rng.integers(0, size, 2))
+        end = tuple(int(min(max(v + rng.integers(-reach, reach + 1), 0), size - 1)) for v in start)
+        if grid[start[0]][start[1]] == 0 and grid[end[0]][end[1]] == 0:
+            queries.append((start, end))
+    return queries
+
+def throughput(run, queries, repeats=3):
+    """Best queries per second over a few runs."""
+    best = float('inf')
+    for _ in range(repeats):
+        started = time.perf_counter()
+        run(queries)
+        best = min(best, time.perf_counter() - started)
+    return len(queries) / best
+
+if __name__ == "__main__":
+    if not hasattr(pathfinder, 'find_paths_interleaved'):
+        sys.exit("This build does not export find_paths_interleaved; see the module docstring")
+    size = int(sys.argv[1]) if len(sys.argv) > 1 else 4000
+    count = int(sys.argv[2]) if len(sys.argv) > 2 else 64
+    print(f"Building {size}x{size} grid and {count} queries")
+    grid = random_grid(size)
+    queries = random_queries(grid, count)
+
+    reference = pathfinder.find_paths(grid, queries, threads=1)
+    sequential = throughput(lambda qs: pathfinder.find_paths(grid, qs, threads=1), queries)
+    print(f"sequential (find_paths, 1 thread): {sequential:8.1f} queries/s")
+    for lanes in (2, 4, 8, 16):
+        if pathfinder.find_paths_interleaved(grid, queries, lanes=lanes) != reference:
+            print(f"lanes={lanes}: paths differ from the sequential run")
+        rate = throughput(lambda qs: pathfinder.find_paths_interleaved(grid, qs, lanes=lanes), queries)
+        verdict = "faster" if rate > sequential else "slower"
+        print(f"interleaved, lanes={lanes:2d}:        {rate:8.1f} queries/s "
+              f"({rate / sequential:.2f}x, {verdict} than sequential)")
@@ -0,0 +1,132 @@
+#include "costmap.h"
+#include <cmath>
+#include <algorithm>
+#include <limits>
+#include <cstdint>
+
+namespace {
+
+// 1-D squared distance transform of `f` (Felzenszwalb and Huttenlocher): lower envelope of
+// the parabolas rooted at each sample. Results above `limit` are stored as `limit`. `v` and
+// `z` are scratch of size n and n + 1.
+void distanceTransform1D(const int* f, int n, int limit, int* d, int* v, double* z) {
+    const double kInf = std::numeric_limits<double>::infinity();
+    int k = 0;
+    v[0] = 0;
+    z[0] = -kInf;
+    z[1] = kInf;
+    for (int q = 1; q < n; q++) {
+        double s;
+        for (;;) {
+            // z[0] is -inf, so this stops at k == 0 at the latest
+            const int p = v[k];
+            s = ((double)f[q] + (double)q * q - (double)f[p] - (double)p * p) / (2.0 * (q - p));
+            if (s > z[k]) {
+                break;
+            }
+            k--;
+        }
+        k++;
+        v[k] = q;
+        z[k] = s;
+        z[k + 1] = kInf;
+    }
+    k = 0;
+    for (int q = 0; q < n; q++) {
+        while (z[k + 1] < q) {
+            k++;
+        }
+        // (q - p)^2 alone passes INT_MAX on rows longer than 46341 cells, so it is not left to
+        // the envelope to keep the sum small
+        const int64_t p = v[k];
+        d[q] = (int)std::min<int64_t>((q - p) * (q - p) + f[p], limit);
+    }
+}
+
+}  // namespace
+
+std::vector<uint8_t> Costmap::costTable(const Params& params) {
+    float reach = std::max(params.inscribed_radius, params.inflation_radius);
+    for (const Band& band : params.bands) {
+        reach = std::max(reach, band.radius);
+    }
+    const int max_sq = (int)std::floor(reach * reach);
+    std::vector<uint8_t> table((size_t)max_sq + 1, kFree);
+
+    for (int sq = 0; sq <= max_sq; sq++) {
+        const float distance = std::sqrt((float)sq);
+        uint8_t cost = kFree;
+        if (sq == 0) {
+            cost = kLethal;
+        } else if (distance <= params.inscribed_radius) {
+            cost = kInscribed;
+        } else if (distance <= params.inflation_radius) {
+            const float decay = std::exp(-params.cost_scaling_factor * (distance - params.inscribed_radius));
+            cost = (uint8_t)((kInscribed - 1) * decay);
+        }
+        for (const Band& band : params.bands) {
+            if (distance <= band.radius) {
+                cost = std::max(cost, band.cost);
+            }
+        }
+        table[sq] = cost;
+    }
+    return table;
+}
+
+void Costmap::inflate(const uint8_t* occupancy, int rows, int cols, const Params& params, uint8_t* out) {
+    if (rows <= 0 || cols <= 0) {
+        return;
+    }
+    const std::vector<uint8_t> table = costTable(params);
+    const int max_sq = (int)table.size() - 1;
+
+    // Distances past the table only need to stay past it, so vertical runs are capped there.
+    // That bounds the column terms; the horizontal offsets grow with the row length, so the 1-D
+    // transform works in 64 bits and clamps to max_sq + 1.
+    const int cap = (int)std::ceil(std::sqrt((float)max_sq)) + 1;
+    const int far = cap * cap * 2 + 1;
+
+    // Vertical pass: distance to the nearest obstacle in the same column. Each step works on a
+    // whole row at once, so the inner loops are straight element-wise and vectorise.
+    std::vector<int> column((size_t)rows * cols);
+    const uint8_t threshold = params.occupied_threshold;
+    for (int y = 0; y < cols; y++) {
+        column[y] = occupancy[y] >= threshold ? 0 : cap;
+    }
+    for (int x = 1; x < rows; x++) {
+        const uint8_t* in = occupancy + (size_t)x * cols;
+        const int* above = column.data() + (size_t)(x - 1) * cols;
+        int* row = column.data() + (size_t)x * cols;
+        for (int y = 0; y < cols; y++) {
+            row[y] = in[y] >= threshold ? 0 : std::min(above[y] + 1, cap);
+        }
+    }
+    for (int x = rows - 2; x >= 0; x--) {
+        const int* below = column.data() + (size_t)(x + 1) * cols;
+        int* row = column.data() + (size_t)x * cols;
+        for (int y = 0; y < cols; y++) {
+            row[y] = std::min(row[y], below[y] + 1);
+        }
+    }
+    for (size_t i = 0; i < column.size(); i++) {
+        column[i] = column[i] >= cap ? far : column[i] * column[i];
+    }
+
+    // Horizontal pass: exact squared distances row by row, mapped through the cost table
+    std::vector<int> squared(cols), v(cols);
+    std::vector<double> z((size_t)cols + 1);
+    for (int x = 0; x < rows; x++) {
+        const int* f = column.data() + (size_t)x * cols;
+        uint8_t* row = out + (size_t)x * cols;
+        // Rows with no obstacle within reach are free throughout
+        if (*std::min_element(f, f + cols) == far) {
+            std::fill(row, row + cols, kFree);
+            continue;
+        }
+        distanceTransform1D(f, cols, max_sq + 1, squared.data(), v.data(), z.data());
+        for (int y = 0; y < cols; y++) {
+            row[y] = squared[y] >= 0 && squared[y] <= max_sq ? table[squared[y]] : kFree;
+        }
+    }
+}
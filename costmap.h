@@ -0,0 +1,40 @@
+#ifndef COSTMAP_H
+#define COSTMAP_H
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+// Layered uint8 costmaps from occupancy grids, in the costmap_2d convention: lethal cells
+// are obstacles, inscribed cells are closer than the robot radius, and cost decays
+// exponentially out to the inflation radius. Grids are row-major, distances in cells.
+class Costmap {
+public:
+    static constexpr uint8_t kLethal = 254;
+    static constexpr uint8_t kInscribed = 253;
+    static constexpr uint8_t kFree = 0;
+
+    // Fixed cost for every cell within `radius` of an obstacle
+    struct Band {
+        float radius;
+        uint8_t cost;
+    };
+
+    struct Params {
+        float inscribed_radius = 0;
+        float inflation_radius = 0;
+        float cost_scaling_factor = 10;  // decay rate of the cost past the inscribed radius
+        uint8_t occupied_threshold = 1;  // cells >= this are obstacles
+        std::vector<Band> bands;         // extra levels; a cell takes the highest applicable cost
+    };
+
+    // Writes the costmap of `occupancy` into `out`. `out` may be `occupancy` itself: the
+    // input is consumed by the first pass, before anything is written.
+    static void inflate(const uint8_t* occupancy, int rows, int cols, const Params& params, uint8_t* out);
+
+private:
+    // Cost per squared distance up to the largest radius; everything further is free
+    static std::vector<uint8_t> costTable(const Params& params);
+};
+
+#endif // COSTMAP_H
@@ -0,0 +1,244 @@
+#include "dubins_table.h"
+#include <cmath>
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+namespace {
+
+const double kTwoPi = 6.283185307179586;
+const char kMagic[4] = {'D', 'B', 'N', 'T'};
+const uint32_t kVersion = 1;
+// Inputs are floats, so two-arc (zero straight) solutions land on either side of p_sq == 0
+const double kEpsilon = 1e-5;
+// Within this many turning radii of the start, short paths exist in pockets smaller than a
+// table cell whose samples all need a full loop; lookups there are solved exactly
+const float kExactRadii = 2.0f;
+
+double mod2pi(double angle) {
+    angle = std::fmod(angle, kTwoPi);
+    return angle < 0 ? angle + kTwoPi : angle;
+}
+
+}  // namespace
+
+DubinsTable::Path DubinsTable::shortestPath(float dx, float dy, float dheading, float turning_radius) {
+    // Normalised configuration of Shkel & Lumelsky: unit radius, goal on the +x axis
+    const double d = std::hypot((double)dx, (double)dy) / turning_radius;
+    const double theta = d > 0 ? mod2pi(std::atan2((double)dy, (double)dx)) : 0.0;
+    const double a = mod2pi(-theta);
+    const double b = mod2pi((double)dheading - theta);
+
+    const double sa = std::sin(a), sb = std::sin(b);
+    const double ca = std::cos(a), cb = std::cos(b);
+    const double c_ab = std::cos(a - b);
+    const double d_sq = d * d;
+
+    Path best = {{'S', 'S', 'S'}, {0, 0, 0}, std::numeric_limits<float>::infinity()};
+    auto consider = [&](const char* word, double t, double p, double q) {
+        // An arc that wraps to just below 2*pi is a rounding artefact of a zero-length arc
+        auto arc = [](double angle) { return angle > kTwoPi - kEpsilon ? 0.0 : angle; };
+        t = arc(t);
+        q = arc(q);
+        const float length = (float)((t + p + q) * turning_radius);
+        if (length < best.length) {
+            best = {{word[0], word[1], word[2]},
+                    {(float)(t * turning_radius), (float)(p * turning_radius), (float)(q * turning_radius)},
+                    length};
+        }
+    };
+
+    // LSL
+    double p_sq = 2 + d_sq - 2 * c_ab + 2 * d * (sa - sb);
+    if (p_sq >= -kEpsilon) {
+        p_sq = std::max(p_sq, 0.0);
+        const double tmp = std::atan2(cb - ca, d + sa - sb);
+        consider("LSL", mod2pi(tmp - a), std::sqrt(p_sq), mod2pi(b - tmp));
+    }
+
+    // RSR
+    p_sq = 2 + d_sq - 2 * c_ab + 2 * d * (sb - sa);
+    if (p_sq >= -kEpsilon) {
+        p_sq = std::max(p_sq, 0.0);
+        const double tmp = std::atan2(ca - cb, d - sa + sb);
+        consider("RSR", mod2pi(a - tmp), std::sqrt(p_sq), mod2pi(tmp - b));
+    }
+
+    // LSR
+    p_sq = -2 + d_sq + 2 * c_ab + 2 * d * (sa + sb);
+    if (p_sq >= -kEpsilon) {
+        p_sq = std::max(p_sq, 0.0);
+        const double p = std::sqrt(p_sq);
+        const double tmp = std::atan2(-ca - cb, d + sa + sb) - std::atan2(-2.0, p);
+        consider("LSR", mod2pi(tmp - a), p, mod2pi(tmp - b));
+    }
+
+    // RSL
+    p_sq = -2 + d_sq + 2 * c_ab - 2 * d * (sa + sb);
+    if (p_sq >= -kEpsilon) {
+        p_sq = std::max(p_sq, 0.0);
+        const double p = std::sqrt(p_sq);
+        const double tmp = std::atan2(ca + cb, d - sa - sb) - std::atan2(2.0, p);
+        consider("RSL", mod2pi(a - tmp), p, mod2pi(b - tmp));
+    }
+
+    // RLR
+    double tmp = (6 - d_sq + 2 * c_ab + 2 * d * (sa - sb)) / 8;
+    if (std::fabs(tmp) <= 1 + kEpsilon) {
+        tmp = std::min(std::max(tmp, -1.0), 1.0);
+        const double p = mod2pi(kTwoPi - std::acos(tmp));
+        const double t = mod2pi(a - std::atan2(ca - cb, d - sa + sb) + p / 2);
+        consider("RLR", t, p, mod2pi(a - b - t + p));
+    }
+
+    // LRL
+    tmp = (6 - d_sq + 2 * c_ab + 2 * d * (sb - sa)) / 8;
+    if (std::fabs(tmp) <= 1 + kEpsilon) {
+        tmp = std::min(std::max(tmp, -1.0), 1.0);
+        const double p = mod2pi(kTwoPi - std::acos(tmp));
+        const double t = mod2pi(-a - std::atan2(ca - cb, d + sa - sb) + p / 2);
+        consider("LRL", t, p, mod2pi(b - a - t + p));
+    }
+
+    return best;
+}
+
+float DubinsTable::dubinsDistance(float dx, float dy, float dheading, float turning_radius) {
+    return shortestPath(dx, dy, dheading, turning_radius).length;
+}
+
+DubinsTable::DubinsTable(float turning_radius, float extent, float resolution, int heading_bins)
+    : turning_radius_(turning_radius), extent_(extent), resolution_(resolution),
+      heading_bins_(std::max(1, heading_bins)) {
+    if (turning_radius <= 0 || extent <= 0 || resolution <= 0) {
+        throw std::invalid_argument("DubinsTable: radius, extent and resolution must be positive");
+    }
+    xy_samples_ = 2 * (int)std::ceil(extent / resolution) + 1;
+    extent_ = (xy_samples_ - 1) / 2 * resolution;
+    table_.resize((size_t)heading_bins_ * xy_samples_ * xy_samples_);
+
+    for (int ih = 0; ih < heading_bins_; ih++) {
+        const float dheading = (float)(kTwoPi * ih / heading_bins_);
+        for (int iy = 0; iy < xy_samples_; iy++) {
+            const float dy = -extent_ + iy * resolution_;
+            for (int ix = 0; ix < xy_samples_; ix++) {
+                const float dx = -extent_ + ix * resolution_;
+                table_[((size_t)ih * xy_samples_ + iy) * xy_samples_ + ix] =
+                    dubinsDistance(dx, dy, dheading, turning_radius_);
+            }
+        }
+    }
+}
+
+float DubinsTable::distance(float dx, float dy, float dheading) const {
+    const float fx = (dx + extent_) / resolution_;
+    const float fy = (dy + extent_) / resolution_;
+    if (fx < 0 || fy < 0 || fx > xy_samples_ - 1 || fy > xy_samples_ - 1 ||
+        std::hypot(dx, dy) < kExactRadii * turning_radius_ + resolution_) {
+        return dubinsDistance(dx, dy, dheading, turning_radius_);
+    }
+    const float fh = (float)(mod2pi(dheading) / kTwoPi * heading_bins_);
+
+    const int x0 = std::min((int)fx, xy_samples_ - 2);
+    const int y0 = std::min((int)fy, xy_samples_ - 2);
+    const int h0 = std::min((int)fh, heading_bins_ - 1);
+    const int h1 = (h0 + 1) % heading_bins_;  // heading wraps around
+
+    // Smallest of the 8 surrounding samples, less half a cell for the change between them.
+    // Interpolating across the jumps in Dubins length overestimates next to them, which a
+    // search heuristic must not do; cells a jump runs through, where the samples spread further
+    // than the distance between them allows, are solved exactly.
+    float nearest = sample(x0, y0, h0);
+    float farthest = nearest;
+    for (int ih : {h0, h1}) {
+        for (int iy = y0; iy <= y0 + 1; iy++) {
+            for (int ix = x0; ix <= x0 + 1; ix++) {
+                nearest = std::min(nearest, sample(ix, iy, ih));
+                farthest = std::max(farthest, sample(ix, iy, ih));
+            }
+        }
+    }
+    const float smooth_spread = 2 * resolution_ + turning_radius_ * (float)(kTwoPi / heading_bins_);
+    if (farthest - nearest > smooth_spread) {
+        return dubinsDistance(dx, dy, dheading, turning_radius_);
+    }
+    return std::max(nearest - 0.5f * resolution_, 0.0f);
+}
+
+float DubinsTable::distance(float from_x, float from_y, float from_heading,
+                            float to_x, float to_y, float to_heading) const {
+    const float c = std::cos(from_heading);
+    const float s = std::sin(from_heading);
+    const float wx = to_x - from_x;
+    const float wy = to_y - from_y;
+    return distance(wx * c + wy * s, -wx * s + wy * c, to_heading - from_heading);
+}
+
+void DubinsTable::save(const std::string& path) const {
+    FILE* file = std::fopen(path.c_str(), "wb");
+    if (!file) {
+        throw std::runtime_error("DubinsTable: could not open " + path + " for writing");
+    }
+    const int32_t dims[2] = {heading_bins_, xy_samples_};
+    const float geometry[3] = {turning_radius_, extent_, resolution_};
+    bool ok = std::fwrite(kMagic, 1, sizeof(kMagic), file) == sizeof(kMagic) &&
+              std::fwrite(&kVersion, sizeof(kVersion), 1, file) == 1 &&
+              std::fwrite(geometry, sizeof(float), 3, file) == 3 &&
+              std::fwrite(dims, sizeof(int32_t), 2, file) == 2 &&
+              std::fwrite(table_.data(), sizeof(float), table_.size(), file) == table_.size();
+    ok = std::fclose(file) == 0 && ok;
+    if (!ok) {
+        throw std::runtime_error("DubinsTable: failed writing " + path);
+    }
+}
+
+DubinsTable DubinsTable::load(const std::string& path) {
+    FILE* file = std::fopen(path.c_str(), "rb");
+    if (!file) {
+        throw std::runtime_error("DubinsTable: could not open " + path);
+    }
+    char magic[4];
+    uint32_t version = 0;
+    float geometry[3];
+    int32_t dims[2];
+    bool ok = std::fread(magic, 1, sizeof(magic), file) == sizeof(magic) &&
+              std::memcmp(magic, kMagic, sizeof(kMagic)) == 0 &&
+              std::fread(&version, sizeof(version), 1, file) == 1 && version == kVersion &&
+              std::fread(geometry, sizeof(float), 3, file) == 3 &&
+              std::fread(dims, sizeof(int32_t), 2, file) == 2;
+
+    // Geometry must be what the constructor would have produced: positive, finite, and an odd
+    // sample count spanning [-extent, extent] at the stored resolution
+    ok = ok && std::isfinite(geometry[0]) && std::isfinite(geometry[1]) && std::isfinite(geometry[2]) &&
+         geometry[0] > 0 && geometry[1] > 0 && geometry[2] > 0 && dims[0] > 0 && dims[1] > 1 && dims[1] % 2 == 1 &&
+         std::fabs((dims[1] - 1) / 2 * geometry[2] - geometry[1]) <= 1e-3f * geometry[1];
+
+    // The payload must be exactly the table: checked against the file size before allocating
+    const size_t samples = ok ? (size_t)dims[0] * dims[1] * dims[1] : 0;
+    if (ok) {
+        const long header = std::ftell(file);
+        ok = header >= 0 && std::fseek(file, 0, SEEK_END) == 0;
+        const long end = ok ? std::ftell(file) : -1;
+        ok = ok && end >= header && (size_t)(end - header) == samples * sizeof(float) &&
+             std::fseek(file, header, SEEK_SET) == 0;
+    }
+
+    DubinsTable table;
+    if (ok) {
+        table.turning_radius_ = geometry[0];
+        table.extent_ = geometry[1];
+        table.resolution_ = geometry[2];
+        table.heading_bins_ = dims[0];
+        table.xy_samples_ = dims[1];
+        table.table_.resize(samples);
+        ok = std::fread(table.table_.data(), sizeof(float), table.table_.size(), file) == table.table_.size();
+    }
+    std::fclose(file);
+    if (!ok) {
+        throw std::runtime_error("DubinsTable: " + path + " is not a valid table file");
+    }
+    return table;
+}
@@ -0,0 +1,58 @@
+#ifndef DUBINS_TABLE_H
+#define DUBINS_TABLE_H
+
+#include <vector>
+#include <string>
+
+// Precomputed Dubins path lengths over relative poses (dx, dy, dheading), expressed in the
+// frame of the start pose. Distances are in grid cells. Queries between samples return a lower
+// bound from the surrounding samples, so the table can serve as an admissible heuristic;
+// queries near the start, across a jump in length, or outside the table use the closed form.
+class DubinsTable {
+public:
+    DubinsTable(float turning_radius, float extent, float resolution, int heading_bins);
+
+    // Shortest forward-only path: three segments, each a left arc, right arc or straight
+    struct Path {
+        char segments[3];  // 'L', 'S' or 'R'
+        float lengths[3];  // arc length of each segment (cells)
+        float length;
+    };
+    static Path shortestPath(float dx, float dy, float dheading, float turning_radius);
+
+    // Length of the shortest forward-only path with the given minimum turning radius
+    static float dubinsDistance(float dx, float dy, float dheading, float turning_radius);
+
+    // Table lookup of a lower bound on dubinsDistance(dx, dy, dheading, turningRadius()),
+    // within about one cell of it
+    float distance(float dx, float dy, float dheading) const;
+
+    // Lookup between two absolute poses
+    float distance(float from_x, float from_y, float from_heading,
+                   float to_x, float to_y, float to_heading) const;
+
+    float turningRadius() const { return turning_radius_; }
+    float extent() const { return extent_; }
+    float resolution() const { return resolution_; }
+    int headingBins() const { return heading_bins_; }
+
+    // Binary file with a small header followed by the float samples; throws std::runtime_error
+    void save(const std::string& path) const;
+    static DubinsTable load(const std::string& path);
+
+private:
+    DubinsTable() = default;
+
+    float sample(int ix, int iy, int iheading) const {
+        return table_[((size_t)iheading * xy_samples_ + iy) * xy_samples_ + ix];
+    }
+
+    float turning_radius_ = 0;
+    float extent_ = 0;       // table covers dx, dy in [-extent, extent]
+    float resolution_ = 0;   // cells between samples along dx and dy
+    int heading_bins_ = 0;   // samples over [0, 2*pi) along dheading
+    int xy_samples_ = 0;
+    std::vector<float> table_;
+};
+
+#endif // DUBINS_TABLE_H
@@ -0,0 +1,170 @@
+#include "dynamic_edt.h"
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+const int kCleared = -1;
+const int kFar = std::numeric_limits<int>::max();
+
+const int kNeighbours[8][2] = {{-1, -1}, {-1, 0}, {-1, 1}, {0, -1}, {0, 1}, {1, -1}, {1, 0}, {1, 1}};
+
+}  // namespace
+
+DynamicEDT::DynamicEDT(int rows, int cols)
+    : rows_(rows), cols_(cols), sq_dist_((size_t)rows * cols, kFar), nearest_((size_t)rows * cols, kCleared),
+      raise_pending_((size_t)rows * cols, 0), queueing_((size_t)rows * cols, NotQueued) {
+    if (rows < 0 || cols < 0) {
+        throw std::invalid_argument("Distance map dimensions must be non-negative");
+    }
+}
+
+DynamicEDT::DynamicEDT(const uint8_t* occupancy, int rows, int cols) : DynamicEDT(rows, cols) {
+    setOccupancy(occupancy);
+    update();
+}
+
+size_t DynamicEDT::checkedIndex(int x, int y) const {
+    if (x < 0 || x >= rows_ || y < 0 || y >= cols_) {
+        throw std::out_of_range("Cell (" + std::to_string(x) + ", " + std::to_string(y) + ") is outside the " +
+                                std::to_string(rows_) + "x" + std::to_string(cols_) + " map");
+    }
+    return index(x, y);
+}
+
+void DynamicEDT::setObstacle(int x, int y) {
+    const size_t cell = checkedIndex(x, y);
+    if (isOccupied(cell)) {
+        return;
+    }
+    sq_dist_[cell] = 0;
+    nearest_[cell] = (int)cell;
+    raise_pending_[cell] = 0;
+    queueing_[cell] = LowerQueued;
+    open_.push({0, (int)cell});
+}
+
+void DynamicEDT::removeObstacle(int x, int y) {
+    const size_t cell = checkedIndex(x, y);
+    if (!isOccupied(cell)) {
+        return;
+    }
+    clearCell(cell);
+    raise_pending_[cell] = 1;
+    queueing_[cell] = RaiseQueued;
+    open_.push({0, (int)cell});
+}
+
+void DynamicEDT::setOccupancy(const uint8_t* occupancy) {
+    for (int x = 0; x < rows_; x++) {
+        for (int y = 0; y < cols_; y++) {
+            const size_t cell = index(x, y);
+            const bool occupied = occupancy[cell] != 0;
+            if (occupied && !isOccupied(cell)) {
+                setObstacle(x, y);
+            } else if (!occupied && isOccupied(cell)) {
+                removeObstacle(x, y);
+            }
+        }
+    }
+}
+
+void DynamicEDT::clearCell(size_t cell) {
+    sq_dist_[cell] = kFar;
+    nearest_[cell] = kCleared;
+}
+
+size_t DynamicEDT::update() {
+    size_t processed = 0;
+    while (!open_.empty()) {
+        const size_t cell = (size_t)open_.top().second;
+        open_.pop();
+        // A cell can sit in the queue several times; only its latest lowering counts
+        if (queueing_[cell] == LowerProcessed) {
+            continue;
+        }
+        processed++;
+        if (raise_pending_[cell]) {
+            raise(cell);
+            raise_pending_[cell] = 0;
+            queueing_[cell] = RaiseProcessed;
+        } else if (nearest_[cell] != kCleared && isOccupied((size_t)nearest_[cell])) {
+            queueing_[cell] = LowerProcessed;
+            lower(cell);
+        }
+    }
+    return processed;
+}
+
+// Clears every neighbour whose nearest obstacle is gone and queues it to raise further;
+// neighbours with a surviving obstacle are queued to lower back into the cleared region
+void DynamicEDT::raise(size_t cell) {
+    const int x = (int)(cell / cols_);
+    const int y = (int)(cell % cols_);
+    for (const auto& offset : kNeighbours) {
+        const int nx = x + offset[0];
+        const int ny = y + offset[1];
+        if (nx < 0 || nx >= rows_ || ny < 0 || ny >= cols_) {
+            continue;
+        }
+        const size_t neighbour = index(nx, ny);
+        if (nearest_[neighbour] == kCleared || raise_pending_[neighbour]) {
+            continue;
+        }
+        if (!isOccupied((size_t)nearest_[neighbour])) {
+            open_.push({sq_dist_[neighbour], (int)neighbour});
+            queueing_[neighbour] = RaiseQueued;
+            raise_pending_[neighbour] = 1;
+            clearCell(neighbour);
+        } else if (queueing_[neighbour] != LowerQueued) {
+            open_.push({sq_dist_[neighbour], (int)neighbour});
+            queueing_[neighbour] = LowerQueued;
+        }
+    }
+}
+
+// Offers this cell's obstacle to its neighbours
+void DynamicEDT::lower(size_t cell) {
+    const int x = (int)(cell / cols_);
+    const int y = (int)(cell % cols_);
+    const int obstacle = nearest_[cell];
+    const int ox = obstacle / cols_;
+    const int oy = obstacle % cols_;
+    for (const auto& offset : kNeighbours) {
+        const int nx = x + offset[0];
+        const int ny = y + offset[1];
+        if (nx < 0 || nx >= rows_ || ny < 0 || ny >= cols_) {
+            continue;
+        }
+        const size_t neighbour = index(nx, ny);
+        if (raise_pending_[neighbour]) {
+            continue;
+        }
+        const int sq_dist = (nx - ox) * (nx - ox) + (ny - oy) * (ny - oy);
+        bool overwrite = sq_dist < sq_dist_[neighbour];
+        if (!overwrite && sq_dist == sq_dist_[neighbour]) {
+            // Ties replace an obstacle that no longer exists
+            overwrite = nearest_[neighbour] == kCleared || !isOccupied((size_t)nearest_[neighbour]);
+        }
+        if (overwrite) {
+            open_.push({sq_dist, (int)neighbour});
+            queueing_[neighbour] = LowerQueued;
+            sq_dist_[neighbour] = sq_dist;
+            nearest_[neighbour] = obstacle;
+        }
+    }
+}
+
+float DynamicEDT::distance(int x, int y) const {
+    const int sq_dist = sq_dist_[checkedIndex(x, y)];
+    return sq_dist == kFar ? std::numeric_limits<float>::infinity() : std::sqrt((float)sq_dist);
+}
+
+void DynamicEDT::distances(float* out) const {
+    const size_t cells = sq_dist_.size();
+    for (size_t i = 0; i < cells; i++) {
+        out[i] = sq_dist_[i] == kFar ? std::numeric_limits<float>::infinity() : std::sqrt((float)sq_dist_[i]);
+    }
+}
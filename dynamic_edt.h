@@ -0,0 +1,70 @@
+#ifndef DYNAMIC_EDT_H
+#define DYNAMIC_EDT_H
+
+#include <vector>
+#include <queue>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <utility>
+
+// Euclidean distance map that is updated incrementally as obstacles appear and disappear
+// (Lau, Sprunk and Burgard, "Improved updating of Euclidean distance maps and Voronoi
+// diagrams", IROS 2010). Every cell stores the obstacle cell nearest to it. Adding an
+// obstacle sends a lowering wave out from it; removing one sends a raise wave that clears
+// the cells which relied on it, followed by a lowering wave from the surviving obstacles
+// around them. Only cells whose nearest obstacle changes are touched.
+//
+// Cells are indexed (x, y) with x the row, like the planner grids; distances are in cells.
+// Coordinates outside the map throw std::out_of_range.
+class DynamicEDT {
+public:
+    // All cells free
+    DynamicEDT(int rows, int cols);
+
+    // `occupancy` is row-major, nonzero cells are obstacles; the map is built right away
+    DynamicEDT(const uint8_t* occupancy, int rows, int cols);
+
+    // Queue a change; distances are brought up to date by update()
+    void setObstacle(int x, int y);
+    void removeObstacle(int x, int y);
+
+    // Queue the difference between the current obstacles and a row-major `occupancy` snapshot
+    void setOccupancy(const uint8_t* occupancy);
+
+    // Propagates the queued changes; returns the number of cells processed
+    size_t update();
+
+    bool isOccupied(int x, int y) const { return isOccupied(checkedIndex(x, y)); }
+
+    // Distance to the nearest obstacle (infinity when the map has none)
+    float distance(int x, int y) const;
+    int squaredDistance(int x, int y) const { return sq_dist_[checkedIndex(x, y)]; }
+
+    // Row-major distances for the whole map
+    void distances(float* out) const;
+
+    int rows() const { return rows_; }
+    int cols() const { return cols_; }
+
+private:
+    enum Queueing : uint8_t { NotQueued, LowerQueued, LowerProcessed, RaiseQueued, RaiseProcessed };
+
+    size_t index(int x, int y) const { return (size_t)x * cols_ + y; }
+    size_t checkedIndex(int x, int y) const;
+    bool isOccupied(size_t cell) const { return sq_dist_[cell] == 0 && nearest_[cell] == (int)cell; }
+    void clearCell(size_t cell);
+    void raise(size_t cell);
+    void lower(size_t cell);
+
+    int rows_, cols_;
+    std::vector<int> sq_dist_;   // squared distance to nearest_, INT32_MAX when cleared
+    std::vector<int> nearest_;   // index of the nearest obstacle cell, -1 when cleared
+    std::vector<uint8_t> raise_pending_;
+    std::vector<uint8_t> queueing_;
+
+    using Entry = std::pair<int, int>;  // (squared distance, cell)
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> open_;
+};
+
+#endif // DYNAMIC_EDT_H
@@ -0,0 +1,59 @@
+#include "grid_pyramid.h"
+#include <algorithm>
+#include <stdexcept>
+
+GridPyramid::GridPyramid(const PathFinder::Grid& grid, const std::vector<int>& factors)
+    : rows_((int)grid.size()), cols_(grid.empty() ? 0 : (int)grid[0].size()), factors_(factors) {
+    std::sort(factors_.begin(), factors_.end());
+    factors_.erase(std::unique(factors_.begin(), factors_.end()), factors_.end());
+    if (!factors_.empty() && factors_[0] < 2) {
+        throw std::invalid_argument("Pyramid factors must be at least 2");
+    }
+
+    // Max-pool the full grid once per level; each pass streams over the rows in order
+    for (int factor : factors_) {
+        const int rows = (rows_ + factor - 1) / factor;
+        const int cols = (cols_ + factor - 1) / factor;
+        PathFinder::Grid level(rows, std::vector<int>(cols, 0));
+        for (int x = 0; x < rows_; x++) {
+            std::vector<int>& coarse = level[x / factor];
+            const std::vector<int>& fine = grid[x];
+            for (int y = 0; y < cols_; y++) {
+                if (fine[y] != 0) {
+                    coarse[y / factor] = 1;
+                }
+            }
+        }
+        levels_.push_back(std::move(level));
+    }
+}
+
+std::shared_ptr<const GridPyramid> PyramidCache::get(const PathFinder::Grid& grid, uint64_t version,
+                                                     const std::vector<int>& factors) {
+    const int rows = (int)grid.size();
+    const int cols = grid.empty() ? 0 : (int)grid[0].size();
+    std::vector<int> sorted = factors;
+    std::sort(sorted.begin(), sorted.end());
+    sorted.erase(std::unique(sorted.begin(), sorted.end()), sorted.end());
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto it = entries_.begin(); it != entries_.end(); ++it) {
+            const GridPyramid& pyramid = *it->pyramid;
+            if (it->version == version && pyramid.rows() == rows && pyramid.cols() == cols &&
+                pyramid.factors() == sorted) {
+                entries_.splice(entries_.begin(), entries_, it);
+                return entries_.front().pyramid;
+            }
+        }
+    }
+
+    // Built outside the lock so other maps stay available meanwhile
+    auto pyramid = std::make_shared<const GridPyramid>(grid, sorted);
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_.push_front({version, pyramid});
+    if (entries_.size() > capacity_) {
+        entries_.pop_back();
+    }
+    return pyramid;
+}
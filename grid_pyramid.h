@@ -0,0 +1,52 @@
+#ifndef GRID_PYRAMID_H
+#define GRID_PYRAMID_H
+
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <list>
+#include <cstdint>
+#include "pathfinder.h"
+
+// Conservative downsampled copies of an occupancy grid: a coarse cell is blocked when any
+// fine cell it covers is blocked, so a path that is free on a coarse level is free on the
+// full grid (up to the cell size).
+class GridPyramid {
+public:
+    // One level per downsampling factor (each relative to the full grid), coarsest last
+    GridPyramid(const PathFinder::Grid& grid, const std::vector<int>& factors);
+
+    size_t levels() const { return levels_.size(); }
+    const PathFinder::Grid& level(size_t i) const { return levels_[i]; }
+    int factor(size_t i) const { return factors_[i]; }
+    int rows() const { return rows_; }
+    int cols() const { return cols_; }
+    const std::vector<int>& factors() const { return factors_; }
+
+private:
+    int rows_, cols_;
+    std::vector<int> factors_;
+    std::vector<PathFinder::Grid> levels_;
+};
+
+// Pyramids of recently used maps, keyed by a caller-supplied map version. The caller bumps
+// the version whenever the map changes; a lookup with a known version skips the rebuild.
+class PyramidCache {
+public:
+    explicit PyramidCache(size_t capacity = 4) : capacity_(capacity) {}
+
+    std::shared_ptr<const GridPyramid> get(const PathFinder::Grid& grid, uint64_t version,
+                                           const std::vector<int>& factors);
+
+private:
+    struct Entry {
+        uint64_t version;
+        std::shared_ptr<const GridPyramid> pyramid;
+    };
+
+    size_t capacity_;
+    std::list<Entry> entries_;  // most recently used first
+    std::mutex mutex_;
+};
+
+#endif // GRID_PYRAMID_H
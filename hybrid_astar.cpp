@@ -0,0 +1,292 @@
+#include "hybrid_astar.h"
+#include <cmath>
+#include <queue>
+#include <unordered_map>
+#include <algorithm>
+#include <limits>
+#include <functional>
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+const float kPi = 3.14159265358979f;
+
+float normalizeAngle(float angle) {
+    angle = std::fmod(angle + kPi, 2.0f * kPi);
+    if (angle < 0) {
+        angle += 2.0f * kPi;
+    }
+    return angle - kPi;
+}
+
+struct HybridNode {
+    HybridAStar::Pose pose;
+    float g;
+    int parent;     // index into the node storage, -1 for the start
+    int steer;      // steering sample that produced this node, -1 for the start
+    int direction;  // driving direction that produced this node, 0 for the start
+};
+
+struct StateEntry {
+    int node;
+    float g;
+    bool closed;
+};
+
+}  // namespace
+
+HybridAStar::Pose HybridAStar::apply(const Pose& from, const Pose& relative) {
+    const float c = std::cos(from.heading);
+    const float s = std::sin(from.heading);
+    return {
+        from.x + relative.x * c - relative.y * s,
+        from.y + relative.x * s + relative.y * c,
+        normalizeAngle(from.heading + relative.heading)
+    };
+}
+
+HybridAStar::Pose HybridAStar::arc(float curvature, float length) {
+    if (std::fabs(curvature) < 1e-6f) {
+        return {length, 0.0f, 0.0f};
+    }
+    return {
+        std::sin(curvature * length) / curvature,
+        (1.0f - std::cos(curvature * length)) / curvature,
+        curvature * length
+    };
+}
+
+std::vector<HybridAStar::Primitive> HybridAStar::buildPrimitives(const Params& params) {
+    std::vector<Primitive> primitives;
+    const int samples = std::max(1, params.steering_samples | 1);  // odd, so straight is included
+    const float max_curvature = 1.0f / params.min_turning_radius;
+    const int substeps = std::max(1, (int)std::ceil(params.step_length / 0.5f));
+
+    std::vector<int> directions = {1};
+    if (params.allow_reverse) {
+        directions.push_back(-1);
+    }
+
+    for (int direction : directions) {
+        for (int i = 0; i < samples; i++) {
+            const float curvature = samples > 1 ? max_curvature * (2.0f * i / (samples - 1) - 1.0f) : 0.0f;
+
+            Primitive primitive;
+            primitive.steer = i;
+            primitive.direction = direction;
+            primitive.length = params.step_length;
+
+            // Arc of constant curvature, sampled finely enough that no cell is skipped
+            for (int k = 1; k <= substeps; k++) {
+                primitive.samples.push_back(arc(curvature, direction * params.step_length * k / substeps));
+            }
+
+            const Pose& end = primitive.samples.back();
+            primitive.dx = end.x;
+            primitive.dy = end.y;
+            primitive.dheading = end.heading;
+
+            primitive.cost = params.step_length * (direction < 0 ? params.reverse_penalty : 1.0f);
+            if (curvature != 0.0f) {
+                primitive.cost += params.steering_penalty * params.step_length;
+            }
+            primitives.push_back(primitive);
+        }
+    }
+
+    return primitives;
+}
+
+bool HybridAStar::collisionFree(const PathFinder::Grid& grid, const Pose& from, const Primitive& primitive) {
+    const int rows = (int)grid.size();
+    const int cols = (int)grid[0].size();
+    for (const auto& sample : primitive.samples) {
+        const Pose pose = apply(from, sample);
+        const int x = (int)std::floor(pose.x + 0.5f);
+        const int y = (int)std::floor(pose.y + 0.5f);
+        if (x < 0 || x >= rows || y < 0 || y >= cols || grid[x][y] != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool HybridAStar::analyticExpansion(const PathFinder::Grid& grid, const Pose& from, const Pose& goal,
+                                    float turning_radius, Trajectory& shot) {
+    const float c = std::cos(from.heading);
+    const float s = std::sin(from.heading);
+    const float wx = goal.x - from.x;
+    const float wy = goal.y - from.y;
+    const DubinsTable::Path path = DubinsTable::shortestPath(
+        wx * c + wy * s, -wx * s + wy * c, goal.heading - from.heading, turning_radius);
+    if (std::isinf(path.length)) {
+        return false;
+    }
+
+    const int rows = (int)grid.size();
+    const int cols = (int)grid[0].size();
+    shot.clear();
+    Pose pose = from;
+    for (int i = 0; i < 3; i++) {
+        if (path.lengths[i] <= 0) {
+            continue;
+        }
+        const float curvature = path.segments[i] == 'L' ? 1.0f / turning_radius
+                              : path.segments[i] == 'R' ? -1.0f / turning_radius : 0.0f;
+        const int steps = std::max(1, (int)std::ceil(path.lengths[i] / 0.5f));
+        const Pose segment_start = pose;
+        for (int k = 1; k <= steps; k++) {
+            pose = apply(segment_start, arc(curvature, path.lengths[i] * k / steps));
+            const int x = (int)std::floor(pose.x + 0.5f);
+            const int y = (int)std::floor(pose.y + 0.5f);
+            if (x < 0 || x >= rows || y < 0 || y >= cols || grid[x][y] != 0) {
+                return false;
+            }
+            shot.push_back(pose);
+        }
+    }
+    return true;
+}
+
+HybridAStar::Trajectory HybridAStar::findPath(const PathFinder::Grid& grid, const Pose& start, const Pose& goal,
+                                              const Params& params) {
+    if (params.min_turning_radius <= 0) {
+        throw std::invalid_argument("min_turning_radius must be positive");
+    }
+    if (params.step_length <= 0) {
+        throw std::invalid_argument("step_length must be positive");
+    }
+    // A table for a wider radius overestimates this vehicle's paths
+    if (params.dubins_table &&
+        std::fabs(params.dubins_table->turningRadius() - params.min_turning_radius) > 1e-4f * params.min_turning_radius) {
+        throw std::invalid_argument("dubins_table was built for turning radius " +
+                                    std::to_string(params.dubins_table->turningRadius()) +
+                                    ", min_turning_radius is " + std::to_string(params.min_turning_radius));
+    }
+    if (grid.empty() || grid[0].empty()) {
+        return {};
+    }
+    const int rows = (int)grid.size();
+    const int cols = (int)grid[0].size();
+
+    auto cellOf = [&](const Pose& pose) {
+        return PathFinder::Point((int)std::floor(pose.x + 0.5f), (int)std::floor(pose.y + 0.5f));
+    };
+    auto inBounds = [&](const PathFinder::Point& p) {
+        return p.first >= 0 && p.first < rows && p.second >= 0 && p.second < cols;
+    };
+
+    const PathFinder::Point start_cell = cellOf(start);
+    const PathFinder::Point goal_cell = cellOf(goal);
+    if (!inBounds(start_cell) || !inBounds(goal_cell) ||
+        grid[start_cell.first][start_cell.second] != 0 || grid[goal_cell.first][goal_cell.second] != 0) {
+        return {};
+    }
+
+    // Obstacle-aware 2D distance to the goal; cells it cannot reach are never expanded
+    const std::vector<float> cost_to_go = PathFinder::distanceField(grid, goal_cell);
+    const DubinsTable* dubins = params.allow_reverse ? nullptr : params.dubins_table;
+    auto heuristic = [&](const Pose& pose) {
+        const PathFinder::Point cell = cellOf(pose);
+        const float h = cost_to_go[(size_t)cell.first * cols + cell.second];
+        if (!dubins || std::isinf(h)) {
+            return h;
+        }
+        return std::max(h, dubins->distance(pose.x, pose.y, pose.heading, goal.x, goal.y, goal.heading));
+    };
+    if (std::isinf(heuristic(start))) {
+        return {};
+    }
+
+    const std::vector<Primitive> primitives = buildPrimitives(params);
+    const int heading_bins = std::max(1, params.heading_bins);
+    auto stateKey = [&](const Pose& pose) {
+        const PathFinder::Point cell = cellOf(pose);
+        int bin = (int)std::floor((pose.heading + kPi) / (2.0f * kPi) * heading_bins);
+        bin = std::min(std::max(bin, 0), heading_bins - 1);
+        return ((long long)cell.first * cols + cell.second) * heading_bins + bin;
+    };
+
+    std::vector<HybridNode> nodes;
+    std::unordered_map<long long, StateEntry> states;
+    using Entry = std::pair<float, int>;
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> open_list;
+
+    const Pose start_pose = {start.x, start.y, normalizeAngle(start.heading)};
+    nodes.push_back({start_pose, 0.0f, -1, -1, 0});
+    states[stateKey(start_pose)] = {0, 0.0f, false};
+    open_list.push({heuristic(start_pose), 0});
+
+    const bool try_shots = !params.allow_reverse && params.analytic_expansion_range > 0;
+    Trajectory shot;
+
+    int expansions = 0;
+    while (!open_list.empty() && expansions < params.max_expansions) {
+        const int current_idx = open_list.top().second;
+        open_list.pop();
+
+        const HybridNode current = nodes[current_idx];
+        const long long current_key = stateKey(current.pose);
+        StateEntry& current_state = states[current_key];
+        if (current_state.closed || current_state.node != current_idx) {
+            continue;  // Stale queue entry
+        }
+        current_state.closed = true;
+        expansions++;
+
+        // Found the goal, either directly or through a collision-free Dubins shot
+        const float goal_dist = std::hypot(current.pose.x - goal.x, current.pose.y - goal.y);
+        const bool reached = goal_dist <= params.goal_tolerance &&
+            std::fabs(normalizeAngle(current.pose.heading - goal.heading)) <= params.heading_tolerance;
+        shot.clear();
+        if (reached || (try_shots && goal_dist <= params.analytic_expansion_range &&
+                        analyticExpansion(grid, current.pose, goal, params.min_turning_radius, shot))) {
+            Trajectory path;
+            for (int idx = current_idx; idx >= 0; idx = nodes[idx].parent) {
+                path.push_back(nodes[idx].pose);
+            }
+            std::reverse(path.begin(), path.end());
+            path.insert(path.end(), shot.begin(), shot.end());
+            return path;
+        }
+
+        // Generate children
+        for (const auto& primitive : primitives) {
+            const Pose next = apply(current.pose, {primitive.dx, primitive.dy, primitive.dheading});
+            if (!inBounds(cellOf(next)) || !collisionFree(grid, current.pose, primitive)) {
+                continue;
+            }
+
+            const float h = heuristic(next);
+            if (std::isinf(h)) {
+                continue;
+            }
+
+            const long long key = stateKey(next);
+            if (key == current_key) {
+                continue;
+            }
+
+            float g = current.g + primitive.cost;
+            if (current.steer >= 0 && current.steer != primitive.steer) {
+                g += params.steering_change_penalty;
+            }
+            if (current.direction != 0 && current.direction != primitive.direction) {
+                g += params.direction_change_penalty;
+            }
+
+            auto it = states.find(key);
+            if (it != states.end() && (it->second.closed || g >= it->second.g)) {
+                continue;
+            }
+
+            nodes.push_back({next, g, current_idx, primitive.steer, primitive.direction});
+            const int node_idx = (int)nodes.size() - 1;
+            states[key] = {node_idx, g, false};
+            open_list.push({g + h, node_idx});
+        }
+    }
+
+    return {};  // Return empty path if none found
+}
@@ -0,0 +1,63 @@
+#ifndef HYBRID_ASTAR_H
+#define HYBRID_ASTAR_H
+
+#include <vector>
+#include "pathfinder.h"
+#include "dubins_table.h"
+
+class HybridAStar {
+public:
+    // Continuous robot pose in grid cells; heading in radians, measured from +x towards +y
+    struct Pose {
+        float x;
+        float y;
+        float heading;
+    };
+    using Trajectory = std::vector<Pose>;
+
+    struct Params {
+        float min_turning_radius = 10.0f;      // cells
+        float step_length = 1.5f;              // arc length of one motion primitive (cells)
+        int steering_samples = 5;              // steering angles per direction, including straight
+        int heading_bins = 72;                 // heading resolution of the closed set
+        bool allow_reverse = false;
+        float reverse_penalty = 2.0f;          // cost multiplier for driving backwards
+        float steering_penalty = 0.05f;        // extra cost per cell driven on a curve
+        float steering_change_penalty = 0.1f;  // extra cost for switching steering angle
+        float direction_change_penalty = 5.0f; // extra cost for switching between forward/reverse
+        float goal_tolerance = 1.0f;           // cells
+        float heading_tolerance = 0.2f;        // radians
+        int max_expansions = 1000000;
+        // Optional precomputed Dubins distances, combined with the Theta* cost-to-go. Its turning
+        // radius must equal min_turning_radius (std::invalid_argument otherwise). Ignored when
+        // reversing is allowed, since Dubins lengths overestimate such paths.
+        const DubinsTable* dubins_table = nullptr;
+        // Forward-only searches try to finish with an exact Dubins shot to the goal once it is
+        // this close (cells); 0 disables. Without it a Dubins heuristic stalls inside the goal tolerance.
+        float analytic_expansion_range = 30.0f;
+    };
+
+    // Kinematically feasible search over (x, y, heading) using precomputed motion primitives.
+    // Collisions are checked against `grid`; the Theta* cost-to-go is the heuristic.
+    static Trajectory findPath(const PathFinder::Grid& grid, const Pose& start, const Pose& goal,
+                               const Params& params);
+
+private:
+    struct Primitive {
+        float dx, dy, dheading;           // end pose relative to the start pose frame
+        std::vector<Pose> samples;        // intermediate poses (relative) used for collision checks
+        float length;
+        float cost;
+        int steer;                        // index into the steering samples
+        int direction;                    // +1 forward, -1 reverse
+    };
+
+    static std::vector<Primitive> buildPrimitives(const Params& params);
+    static Pose arc(float curvature, float length);
+    static Pose apply(const Pose& from, const Pose& relative);
+    static bool analyticExpansion(const PathFinder::Grid& grid, const Pose& from, const Pose& goal,
+                                  float turning_radius, Trajectory& shot);
+    static bool collisionFree(const PathFinder::Grid& grid, const Pose& from, const Primitive& primitive);
+};
+
+#endif // HYBRID_ASTAR_H
@@ -0,0 +1,225 @@
+#include "navigator.h"
+#include <cmath>
+#include <algorithm>
+#include <stdexcept>
+
+namespace {
+
+// Segments checked past the best match before the scan gives up, so small wiggles in the
+// path (where the distance briefly grows again) do not stop the tracker
+const size_t kPatience = 8;
+
+size_t checkColumns(size_t columns) {
+    if (columns < PathNavigator::kColumns) {
+        throw std::invalid_argument("Expected 6 columns (x,y,curvature,heading,distance,speed_limit)");
+    }
+    return columns;
+}
+
+}  // namespace
+
+PathNavigator::PathNavigator(const double* path_data, size_t count, size_t columns, size_t window_size,
+                             double relocalization_distance)
+    : index_(path_data, count, checkColumns(columns)), window_size_(std::max<size_t>(window_size, 2)),
+      relocalization_distance_(relocalization_distance), current_segment_(0), current_index_(0),
+      current_distance_(0.0), relocalize_pending_(false) {
+    points_.reserve(count);
+    for (size_t i = 0; i < count; i++) {
+        const double* row = path_data + i * columns;
+        points_.push_back({row[0], row[1], row[2], row[3], row[4], row[5]});
+    }
+
+    // Buckets of the mean row spacing, so each lookup lands within a row or two of its answer
+    arc_step_ = 1.0;
+    if (count > 1) {
+        const double length = points_.back().distance - points_.front().distance;
+        if (length > 0) {
+            arc_step_ = length / (count - 1);
+        }
+    }
+    if (count > 0) {
+        const double start = points_.front().distance;
+        const size_t buckets = (size_t)((points_.back().distance - start) / arc_step_) + 1;
+        arc_index_.resize(buckets);
+        size_t row = 0;
+        for (size_t b = 0; b < buckets; b++) {
+            while (row + 1 < count && points_[row + 1].distance <= start + b * arc_step_) {
+                row++;
+            }
+            arc_index_[b] = row;
+        }
+    }
+    current_distance_ = count > 0 ? points_.front().distance : 0.0;
+}
+
+void PathNavigator::setPath(const double* path_data, size_t count, size_t columns) {
+    *this = PathNavigator(path_data, count, columns, window_size_, relocalization_distance_);
+    relocalize_pending_ = count > 0;
+}
+
+void PathNavigator::reset() {
+    current_segment_ = 0;
+    current_index_ = 0;
+    current_distance_ = points_.empty() ? 0.0 : points_.front().distance;
+}
+
+double PathNavigator::project(size_t segment, double x, double y, double& ratio) const {
+    const PathPoint& a = points_[segment];
+    const PathPoint& b = points_[std::min(segment + 1, points_.size() - 1)];
+    const double sx = b.x - a.x;
+    const double sy = b.y - a.y;
+    const double length_sq = sx * sx + sy * sy;
+    ratio = length_sq > 0 ? ((x - a.x) * sx + (y - a.y) * sy) / length_sq : 0.0;
+    ratio = std::min(std::max(ratio, 0.0), 1.0);
+    const double dx = x - (a.x + sx * ratio);
+    const double dy = y - (a.y + sy * ratio);
+    return dx * dx + dy * dy;
+}
+
+PathNavigator::NavInfo PathNavigator::describe(size_t segment, double ratio, double x, double y) const {
+    const PathPoint& a = points_[segment];
+    const PathPoint& b = points_[std::min(segment + 1, points_.size() - 1)];
+
+    // Shortest way round between the two headings
+    double turn = std::fmod(b.heading - a.heading + 540.0, 360.0) - 180.0;
+    double heading = std::fmod(a.heading + turn * ratio + 360.0, 360.0);
+
+    // Offset is measured against the segment direction; a degenerate segment falls back to
+    // the stored heading like the Python navigator did
+    double ux = b.x - a.x;
+    double uy = b.y - a.y;
+    const double length = std::sqrt(ux * ux + uy * uy);
+    if (length > 0) {
+        ux /= length;
+        uy /= length;
+    } else {
+        const double radians = a.heading * 3.14159265358979323846 / 180.0;
+        ux = std::cos(radians);
+        uy = std::sin(radians);
+    }
+    const double offset = ux * (y - a.y) - uy * (x - a.x);
+
+    NavInfo info;
+    info.distance_from_start = a.distance + (b.distance - a.distance) * ratio;
+    info.heading = heading;
+    info.speed_limit = a.speed_limit + (b.speed_limit - a.speed_limit) * ratio;
+    info.path_offset = offset;
+    info.is_last_point = nearestRow(segment, ratio) == points_.size() - 1;
+    info.segment = segment;
+    info.ratio = ratio;
+    return info;
+}
+
+PathNavigator::NavInfo PathNavigator::update(double x, double y) {
+    if (points_.empty()) {
+        throw std::runtime_error("PathNavigator has no path");
+    }
+    if (relocalize_pending_) {
+        return relocalize(x, y);
+    }
+
+    double best_ratio;
+    double best = project(current_segment_, x, y, best_ratio);
+    size_t best_segment = current_segment_;
+    const size_t max_steps = window_size_ / 2;
+    const size_t segments = segmentCount();
+
+    // Walk forward, then backward, from the current segment while the match keeps improving
+    size_t misses = 0;
+    for (size_t s = current_segment_ + 1; s < segments && s - current_segment_ <= max_steps; s++) {
+        double ratio;
+        const double d = project(s, x, y, ratio);
+        if (d <= best) {
+            best = d;
+            best_ratio = ratio;
+            best_segment = s;
+            misses = 0;
+        } else if (++misses > kPatience) {
+            break;
+        }
+    }
+    if (best_segment == current_segment_) {
+        misses = 0;
+        for (size_t s = current_segment_; s-- > 0 && current_segment_ - s <= max_steps;) {
+            double ratio;
+            const double d = project(s, x, y, ratio);
+            if (d < best) {
+                best = d;
+                best_ratio = ratio;
+                best_segment = s;
+                misses = 0;
+            } else if (++misses > kPatience) {
+                break;
+            }
+        }
+    }
+
+    // Poor windowed match: localization probably jumped, look over the whole path
+    if (relocalization_distance_ > 0 && best > relocalization_distance_ * relocalization_distance_) {
+        const SegmentIndex::Match match = index_.nearest(x, y);
+        if (match.distance_sq < best) {
+            best_segment = match.segment;
+            best_ratio = match.ratio;
+        }
+    }
+
+    current_segment_ = best_segment;
+    current_index_ = nearestRow(best_segment, best_ratio);
+    const NavInfo info = describe(best_segment, best_ratio, x, y);
+    current_distance_ = info.distance_from_start;
+    return info;
+}
+
+PathNavigator::NavInfo PathNavigator::relocalize(double x, double y) {
+    if (points_.empty()) {
+        throw std::runtime_error("PathNavigator has no path");
+    }
+    const SegmentIndex::Match match = index_.nearest(x, y);
+    relocalize_pending_ = false;
+    current_segment_ = match.segment;
+    current_index_ = nearestRow(match.segment, match.ratio);
+    const NavInfo info = describe(match.segment, match.ratio, x, y);
+    current_distance_ = info.distance_from_start;
+    return info;
+}
+
+void PathNavigator::updateBatch(const double* poses, size_t count, double* out) {
+    for (size_t i = 0; i < count; i++) {
+        const NavInfo info = update(poses[2 * i], poses[2 * i + 1]);
+        double* row = out + i * kBatchColumns;
+        row[0] = info.distance_from_start;
+        row[1] = info.heading;
+        row[2] = info.speed_limit;
+        row[3] = info.path_offset;
+        row[4] = info.is_last_point ? 1.0 : 0.0;
+    }
+}
+
+PathNavigator::PathSample PathNavigator::pointAt(double distance) const {
+    if (points_.empty()) {
+        throw std::runtime_error("PathNavigator has no path");
+    }
+    const double start = points_.front().distance;
+    distance = std::min(std::max(distance, start), points_.back().distance);
+
+    const size_t bucket = std::min((size_t)((distance - start) / arc_step_), arc_index_.size() - 1);
+    size_t row = arc_index_[bucket];
+    while (row + 1 < points_.size() && points_[row + 1].distance <= distance) {
+        row++;
+    }
+
+    const PathPoint& a = points_[row];
+    const PathPoint& b = points_[std::min(row + 1, points_.size() - 1)];
+    const double span = b.distance - a.distance;
+    const double ratio = span > 0 ? (distance - a.distance) / span : 0.0;
+    const double turn = std::fmod(b.heading - a.heading + 540.0, 360.0) - 180.0;
+
+    PathSample sample;
+    sample.x = a.x + (b.x - a.x) * ratio;
+    sample.y = a.y + (b.y - a.y) * ratio;
+    sample.heading = std::fmod(a.heading + turn * ratio + 360.0, 360.0);
+    sample.curvature = a.curvature + (b.curvature - a.curvature) * ratio;
+    sample.speed_limit = a.speed_limit + (b.speed_limit - a.speed_limit) * ratio;
+    sample.distance = distance;
+    return sample;
+}
@@ -0,0 +1,99 @@
+#ifndef NAVIGATOR_H
+#define NAVIGATOR_H
+
+#include <vector>
+#include <cstddef>
+#include <algorithm>
+#include "segment_index.h"
+
+// Native path tracker for path_data_with_speeds rows
+// (x, y, curvature, heading, distance, speed_limit). The robot is projected onto the path
+// segment it is on; the segment index is tracked incrementally between updates, so a
+// control tick costs O(distance moved) instead of a scan over a window of points. When the
+// tracked match is poor (localization jumped), a spatial index over all segments supplies
+// the globally nearest one instead.
+class PathNavigator {
+public:
+    struct NavInfo {
+        double distance_from_start;  // cm along the path at the projection
+        double heading;              // degrees in [0, 360), interpolated along the segment
+        double speed_limit;          // cm/s, interpolated along the segment
+        double path_offset;          // signed distance from the path, positive to the left (cm)
+        bool is_last_point;          // the row nearest the projection is the last one
+        size_t segment;              // index of the row starting the current segment
+        double ratio;                // position along the segment in [0, 1]
+    };
+
+    // `path_data` is row-major with at least 6 columns. `window_size` bounds how many rows
+    // the tracker may move per update (the same window the Python navigator searched).
+    // A `relocalization_distance` (cm) of 0 or less disables the global fallback.
+    PathNavigator(const double* path_data, size_t count, size_t columns, size_t window_size = 500,
+                  double relocalization_distance = 50.0);
+
+    NavInfo update(double x, double y);
+
+    // Switches to a new trajectory (e.g. a replan) keeping the window and relocalization
+    // settings; the next update() starts from the globally nearest segment of the new path
+    void setPath(const double* path_data, size_t count, size_t columns);
+
+    // Jump to the globally nearest segment regardless of the tracked one
+    NavInfo relocalize(double x, double y);
+
+    // update() for `count` row-major (x, y) poses in order, carrying the tracking state across
+    // them. Writes kBatchColumns values per pose: distance_from_start, heading, speed_limit,
+    // path_offset and is_last_point (0 or 1).
+    void updateBatch(const double* poses, size_t count, double* out);
+
+    static constexpr size_t kBatchColumns = 5;
+
+    struct PathSample {
+        double x, y;
+        double heading;      // degrees in [0, 360)
+        double curvature;    // degrees/cm
+        double speed_limit;  // cm/s
+        double distance;     // cm from the start, clamped to the path
+    };
+
+    // Path state at arc length `distance` from the start, interpolated between rows. O(1):
+    // a uniform arc-length index gives the row directly.
+    PathSample pointAt(double distance) const;
+
+    // pointAt() `distance` cm ahead of the last projected position (pure-pursuit target)
+    PathSample lookahead(double distance) const { return pointAt(current_distance_ + distance); }
+
+    // Index of the row closest to the last projection
+    size_t currentIndex() const { return current_index_; }
+    size_t size() const { return points_.size(); }
+    void reset();
+
+    static constexpr size_t kColumns = 6;
+
+private:
+    struct PathPoint {
+        double x, y, curvature, heading, distance, speed_limit;
+    };
+
+    // Squared distance from (x, y) to the segment starting at row `segment`; `ratio`
+    // receives the clamped projection parameter
+    double project(size_t segment, double x, double y, double& ratio) const;
+    NavInfo describe(size_t segment, double ratio, double x, double y) const;
+    size_t segmentCount() const { return points_.size() > 1 ? points_.size() - 1 : 1; }
+
+    // Row of the segment end the projection is closer to
+    size_t nearestRow(size_t segment, double ratio) const {
+        return std::min(segment + (ratio > 0.5 ? 1 : 0), points_.size() - 1);
+    }
+
+    std::vector<PathPoint> points_;
+    SegmentIndex index_;
+    std::vector<size_t> arc_index_;  // last row at or before each arc_step_ bucket start
+    double arc_step_;
+    size_t window_size_;
+    double relocalization_distance_;
+    size_t current_segment_;
+    size_t current_index_;
+    double current_distance_;
+    bool relocalize_pending_;
+};
+
+#endif // NAVIGATOR_H
@@ -0,0 +1,213 @@
+#include "path_file.h"
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+const char kMagic[4] = {'W', 'P', 'T', 'S'};
+const uint16_t kVersion = 1;
+
+// Columns are stored in host order; only little-endian hosts produce and map the format
+bool littleEndian() {
+    const uint16_t probe = 1;
+    return *reinterpret_cast<const uint8_t*>(&probe) == 1;
+}
+
+void putLE(uint8_t* out, uint64_t value, int bytes) {
+    for (int i = 0; i < bytes; i++) {
+        out[i] = (uint8_t)(value >> (8 * i));
+    }
+}
+
+uint64_t getLE(const uint8_t* in, int bytes) {
+    uint64_t value = 0;
+    for (int i = 0; i < bytes; i++) {
+        value |= (uint64_t)in[i] << (8 * i);
+    }
+    return value;
+}
+
+void encodeHeader(uint8_t* header, PathFile::DType dtype, size_t columns, uint64_t rows) {
+    std::memset(header, 0, PathFile::kHeaderSize);
+    std::memcpy(header, kMagic, 4);
+    putLE(header + 4, kVersion, 2);
+    header[6] = dtype;
+    putLE(header + 8, columns, 4);
+    putLE(header + 16, rows, 8);
+}
+
+// Validates the header and returns its fields
+void decodeHeader(const uint8_t* header, const std::string& path, PathFile::DType& dtype, size_t& columns,
+                  uint64_t& rows) {
+    if (std::memcmp(header, kMagic, 4) != 0 || getLE(header + 4, 2) != kVersion ||
+        (header[6] != PathFile::Int32 && header[6] != PathFile::Float32) || getLE(header + 8, 4) == 0) {
+        throw std::runtime_error("Not a waypoint file: " + path);
+    }
+    dtype = (PathFile::DType)header[6];
+    columns = (size_t)getLE(header + 8, 4);
+    rows = getLE(header + 16, 8);
+}
+
+std::runtime_error ioError(const std::string& what, const std::string& path) {
+    return std::runtime_error(what + " " + path + ": " + std::strerror(errno));
+}
+
+}  // namespace
+
+PathFile::Writer::Writer(const std::string& path, DType dtype, size_t columns, bool append)
+    : path_(path), dtype_(dtype), columns_(columns), rows_(0), file_(nullptr) {
+    if (!littleEndian()) {
+        throw std::runtime_error("Waypoint files require a little-endian host");
+    }
+    if (columns == 0) {
+        throw std::invalid_argument("Waypoint files need at least one column");
+    }
+
+    if (append) {
+        file_ = std::fopen(path.c_str(), "r+b");
+    }
+    if (file_) {
+        uint8_t header[kHeaderSize];
+        DType existing_dtype;
+        size_t existing_columns;
+        if (std::fread(header, 1, kHeaderSize, file_) != kHeaderSize) {
+            std::fclose(file_);
+            throw std::runtime_error("Not a waypoint file: " + path);
+        }
+        try {
+            decodeHeader(header, path, existing_dtype, existing_columns, rows_);
+        } catch (...) {
+            std::fclose(file_);
+            throw;
+        }
+        if (existing_dtype != dtype || existing_columns != columns) {
+            std::fclose(file_);
+            throw std::invalid_argument("Cannot append: " + path + " has a different dtype or column count");
+        }
+        // Rows past the recorded count belong to an interrupted append and are overwritten
+        if (std::fseek(file_, (long)(kHeaderSize + rows_ * columns_ * 4), SEEK_SET) != 0) {
+            std::fclose(file_);
+            throw ioError("Cannot seek in", path);
+        }
+        return;
+    }
+
+    file_ = std::fopen(path.c_str(), "wb");
+    if (!file_) {
+        throw ioError("Cannot create", path);
+    }
+    uint8_t header[kHeaderSize];
+    encodeHeader(header, dtype_, columns_, 0);
+    if (std::fwrite(header, 1, kHeaderSize, file_) != kHeaderSize) {
+        std::fclose(file_);
+        throw ioError("Cannot write", path);
+    }
+}
+
+PathFile::Writer::~Writer() {
+    try {
+        close();
+    } catch (...) {
+        // Destructors cannot report the failure; call close() to see it
+    }
+}
+
+void PathFile::Writer::write(const void* data, size_t count, DType dtype) {
+    if (!file_) {
+        throw std::runtime_error("Waypoint file is closed: " + path_);
+    }
+    if (dtype != dtype_) {
+        throw std::invalid_argument("Row dtype does not match waypoint file " + path_);
+    }
+    const size_t values = count * columns_;
+    if (std::fwrite(data, 4, values, file_) != values) {
+        throw ioError("Cannot write", path_);
+    }
+    rows_ += count;
+}
+
+void PathFile::Writer::append(const int32_t* rows, size_t count) {
+    write(rows, count, Int32);
+}
+
+void PathFile::Writer::append(const float* rows, size_t count) {
+    write(rows, count, Float32);
+}
+
+void PathFile::Writer::flush() {
+    if (!file_) {
+        return;
+    }
+    // Data first, then the row count that makes it visible
+    uint8_t count[8];
+    putLE(count, rows_, 8);
+    const long end = std::ftell(file_);
+    if (std::fflush(file_) != 0 || std::fseek(file_, 16, SEEK_SET) != 0 ||
+        std::fwrite(count, 1, 8, file_) != 8 || std::fflush(file_) != 0 ||
+        std::fseek(file_, end, SEEK_SET) != 0) {
+        throw ioError("Cannot write", path_);
+    }
+}
+
+void PathFile::Writer::close() {
+    if (!file_) {
+        return;
+    }
+    std::FILE* file = file_;
+    try {
+        flush();
+    } catch (...) {
+        std::fclose(file);
+        file_ = nullptr;
+        throw;
+    }
+    file_ = nullptr;
+    if (std::fclose(file) != 0) {
+        throw ioError("Cannot close", path_);
+    }
+}
+
+PathFile::Reader::Reader(const std::string& path) : dtype_(Int32), columns_(0), rows_(0), mapped_size_(0), mapping_(nullptr) {
+    if (!littleEndian()) {
+        throw std::runtime_error("Waypoint files require a little-endian host");
+    }
+    const int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw ioError("Cannot open", path);
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || (size_t)info.st_size < kHeaderSize) {
+        ::close(fd);
+        throw std::runtime_error("Not a waypoint file: " + path);
+    }
+    mapped_size_ = (size_t)info.st_size;
+    mapping_ = mmap(nullptr, mapped_size_, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (mapping_ == MAP_FAILED) {
+        mapping_ = nullptr;
+        throw ioError("Cannot map", path);
+    }
+
+    try {
+        decodeHeader(static_cast<const uint8_t*>(mapping_), path, dtype_, columns_, rows_);
+        if (rows_ > (mapped_size_ - kHeaderSize) / (columns_ * 4)) {
+            throw std::runtime_error("Truncated waypoint file: " + path);
+        }
+    } catch (...) {
+        munmap(mapping_, mapped_size_);
+        mapping_ = nullptr;
+        throw;
+    }
+}
+
+PathFile::Reader::~Reader() {
+    if (mapping_) {
+        munmap(mapping_, mapped_size_);
+    }
+}
+
@@ -0,0 +1,81 @@
+#ifndef PATH_FILE_H
+#define PATH_FILE_H
+
+#include <string>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+
+// Binary waypoint / trajectory files: a 32-byte little-endian header followed by row-major
+// int32 or float32 columns. The data starts 32 bytes in, so files can be memory-mapped
+// directly (np.memmap(path, dtype, offset=32)).
+//
+//   0  char[4]  magic "WPTS"
+//   4  uint16   version (1)
+//   6  uint8    dtype (PathFile::Int32 or PathFile::Float32)
+//   7  uint8    reserved
+//   8  uint32   columns
+//  12  uint32   reserved
+//  16  uint64   rows
+//  24  uint64   reserved
+class PathFile {
+public:
+    enum DType : uint8_t { Int32 = 0, Float32 = 1 };
+
+    static constexpr size_t kHeaderSize = 32;
+
+    // Appends rows to a file, streaming; the row count in the header is patched on flush() and
+    // close(), so an interrupted writer leaves a valid file holding the rows flushed so far.
+    // Throws std::runtime_error on I/O errors.
+    class Writer {
+    public:
+        // `append` continues an existing file, whose dtype and columns must match
+        Writer(const std::string& path, DType dtype, size_t columns, bool append = false);
+        ~Writer();
+
+        Writer(const Writer&) = delete;
+        Writer& operator=(const Writer&) = delete;
+
+        void append(const int32_t* rows, size_t count);
+        void append(const float* rows, size_t count);
+        void flush();
+        void close();
+
+        uint64_t rows() const { return rows_; }
+        size_t columns() const { return columns_; }
+        DType dtype() const { return dtype_; }
+
+    private:
+        void write(const void* data, size_t count, DType dtype);
+
+        std::string path_;
+        DType dtype_;
+        size_t columns_;
+        uint64_t rows_;
+        std::FILE* file_;
+    };
+
+    // Read-only memory map of a whole file; data() points at the first row
+    class Reader {
+    public:
+        explicit Reader(const std::string& path);
+        ~Reader();
+
+        Reader(const Reader&) = delete;
+        Reader& operator=(const Reader&) = delete;
+
+        const void* data() const { return static_cast<const char*>(mapping_) + kHeaderSize; }
+        uint64_t rows() const { return rows_; }
+        size_t columns() const { return columns_; }
+        DType dtype() const { return dtype_; }
+
+    private:
+        DType dtype_;
+        size_t columns_;
+        uint64_t rows_;
+        size_t mapped_size_;
+        void* mapping_;
+    };
+};
+
+#endif // PATH_FILE_H
@@ -1,19 +1,66 @@
 import numpy as np
+import pathfinder  # Our C++ module
 
 class PathNavigator:
-    def __init__(self, path_file='path_data_with_speeds.npy', window_size=500):
-        """Initialize with path data and search window size."""
+    def __init__(self, path_file='path_data_with_speeds.npy', window_size=500, relocalization_distance=50.0,
+                 channel=None):
+        """Initialize with path data and search window size.
+        
+        When the tracked match is further than relocalization_distance (cm) from the robot,
+        the nearest point over the whole path is used instead (0 disables).
+        
+        If channel names a shared-memory trajectory segment (see pathfinder.TrajectoryPublisher),
+        the path is taken from it instead of path_file, and every update picks up newly
+        published paths without file I/O.
+        """
+        self.window_size = window_size
+        self._channel = channel
+        self._subscriber = None
+        self._generation = 0
         try:
-            self.path_data = np.load(path_file)
+            if channel is not None:
+                self._subscriber = pathfinder.TrajectorySubscriber(channel)
+                self.path_data, self._generation = self._subscriber.read()
+            else:
+                self.path_data = np.load(path_file)
             if self.path_data.shape[1] != 6:
                 raise ValueError("Expected 6 columns (x,y,curvature,heading,distance,speed_limit)")
         except Exception as e:
             print(f"Error loading path data: {str(e)}")
             raise
         
-        self.current_idx = 0
-        self.window_size = window_size
         self.path_length = len(self.path_data)
+        # Segment tracking and projection run natively
+        self._tracker = pathfinder.PathNavigator(self.path_data, window_size, relocalization_distance)
+        
+    def poll_trajectory(self):
+        """
+        Switch to the latest published trajectory if the channel has a new one.
+        Returns True when the path changed; tracking relocalizes on the next update.
+        
+        A retired segment (a planner restarted with another capacity, or the channel was
+        removed) is reopened by name; the current path is kept until the new segment exists
+        and has a trajectory.
+        """
+        if self._subscriber is None:
+            return False
+        if self._subscriber.retired:
+            try:
+                self._subscriber = pathfinder.TrajectorySubscriber(self._channel)
+            except RuntimeError:
+                return False
+            self._generation = 0
+        if self._subscriber.generation == self._generation:
+            return False
+        self.path_data, self._generation = self._subscriber.read()
+        self.path_length = len(self.path_data)
+        self._tracker.set_path(self.path_data)
+        return True
+        
+    @property
+    def current_idx(self):
+        """Index of the path point closest to the last position."""
+        return self._tracker.current_index
         
     def update_position(self, robot_x, robot_y):
         """
@@ -25,38 +72,65 @@ class PathNavigator:
         - path_offset (signed distance from path)
         - is_last_point
         """
-        # Find nearest point in window around current position
-        search_start = max(0, self.current_idx - self.window_size//2)
-        search_end = min(self.path_length, self.current_idx + self.window_size//2)
-        
-        window = self.path_data[search_start:search_end]
-        if len(window) == 0:
+        self.poll_trajectory()
+        if self.path_length == 0:
             return None
-            
-        # Calculate distances to all points in window
-        dx = window[:,0] - robot_x
-        dy = window[:,1] - robot_y
-        distances = dx**2 + dy**2
         
-        # Update current_idx to nearest point
-        nearest_in_window = np.argmin(distances)
-        self.current_idx = search_start + nearest_in_window
-        point = self.path_data[self.current_idx]
+        # Project onto the tracked path segment; values are interpolated along it
+        info = self._tracker.update(robot_x, robot_y)
         
-        # Calculate signed offset from path
-        path_heading = np.radians(point[3])
-        dx = robot_x - point[0]
-        dy = robot_y - point[1]
+        return {
+            'distance_from_start': info.distance_from_start,
+            'heading': info.heading,
+            'speed_limit': info.speed_limit,
+            'path_offset': info.path_offset,
+            'is_last_point': info.is_last_point
+        }
+        
+    def update_positions(self, poses):
+        """
+        Track a sequence of (N, 2) robot positions in one native call, e.g. for simulation
+        or log replay. Tracking state carries over between poses and into later updates.
+        Returns an (N, 5) array of distance_from_start, heading, speed_limit, path_offset,
+        is_last_point (0/1) rows.
+        """
+        poses = np.asarray(poses, dtype=np.float64).reshape(-1, 2)
+        if self.path_length == 0:
+            return np.empty((0, 5))
+        return self._tracker.update_batch(poses)
+        
+    def relocalize(self, robot_x, robot_y):
+        """Snap to the nearest point over the whole path, e.g. after a localization reset."""
+        if self.path_length == 0:
+            return None
+        self._tracker.relocalize(robot_x, robot_y)
+        return self.update_position(robot_x, robot_y)
+        
+    def lookahead(self, distance):
+        """
+        Pure-pursuit target: path state `distance` cm ahead of the last projected position.
+        Returns dict with x, y, heading, curvature, speed_limit and distance (from start),
+        interpolated between path points and clamped to the end of the path.
+        """
+        if self.path_length == 0:
+            return None
+        return self._sample_dict(self._tracker.lookahead(distance))
         
-        # Rotate robot position to path frame
-        offset = -dx * np.sin(path_heading) + dy * np.cos(path_heading)
+    def point_at(self, distance):
+        """Path state at `distance` cm from the start, in the same form as lookahead()."""
+        if self.path_length == 0:
+            return None
+        return self._sample_dict(self._tracker.point_at(distance))
         
+    @staticmethod
+    def _sample_dict(sample):
         return {
-            'distance_from_start': point[4],
-            'heading': point[3],
-            'speed_limit': point[5],
-            'path_offset': offset,
-            'is_last_point': self.current_idx == self.path_length - 1
+            'x': sample.x,
+            'y': sample.y,
+            'heading': sample.heading,
+            'curvature': sample.curvature,
+            'speed_limit': sample.speed_limit,
+            'distance': sample.distance
         }
         
     def get_current_point(self):
@@ -67,3 +141,4 @@ class PathNavigator:
         
     def reset(self):
         """Reset navigator to start of path."""
+        self._tracker.reset()
@@ -0,0 +1,140 @@
+#include "path_processing.h"
+#include <cmath>
+#include <algorithm>
+
+namespace {
+
+// Position at increasing arc lengths along a polyline, advancing the segment index
+// monotonically so a full sweep costs O(points + queries)
+class PolylineCursor {
+public:
+    PolylineCursor(const double* xy, const std::vector<double>& cumulative)
+        : xy_(xy), cumulative_(cumulative), segment_(0) {}
+
+    void at(double s, double& x, double& y) {
+        const size_t last = cumulative_.size() - 1;
+        if (s >= cumulative_[last]) {
+            x = xy_[2 * last];
+            y = xy_[2 * last + 1];
+            return;
+        }
+        while (segment_ + 1 < last && cumulative_[segment_ + 1] <= s) {
+            segment_++;
+        }
+        const double length = cumulative_[segment_ + 1] - cumulative_[segment_];
+        const double ratio = length > 0 ? (s - cumulative_[segment_]) / length : 0.0;
+        const double* start = xy_ + 2 * segment_;
+        x = start[0] + (start[2] - start[0]) * ratio;
+        y = start[1] + (start[3] - start[1]) * ratio;
+    }
+
+private:
+    const double* xy_;
+    const std::vector<double>& cumulative_;
+    size_t segment_;
+};
+
+}  // namespace
+
+std::vector<double> PathProcessing::cumulativeLengths(const double* xy, size_t count) {
+    std::vector<double> cumulative(count, 0.0);
+    for (size_t i = 1; i < count; i++) {
+        const double dx = xy[2 * i] - xy[2 * i - 2];
+        const double dy = xy[2 * i + 1] - xy[2 * i - 1];
+        cumulative[i] = cumulative[i - 1] + std::sqrt(dx * dx + dy * dy);
+    }
+    return cumulative;
+}
+
+std::vector<double> PathProcessing::resample(const double* xy, size_t count, double step) {
+    std::vector<double> out;
+    if (count == 0 || step <= 0) {
+        return out;
+    }
+    const std::vector<double> cumulative = cumulativeLengths(xy, count);
+    const double total = cumulative.back();
+    const size_t samples = (size_t)std::floor(total / step) + 1;
+    out.reserve(2 * (samples + 1));
+
+    PolylineCursor cursor(xy, cumulative);
+    double x, y;
+    for (size_t k = 0; k < samples; k++) {
+        cursor.at(k * step, x, y);
+        out.push_back(x);
+        out.push_back(y);
+    }
+    if ((samples - 1) * step < total) {
+        out.push_back(xy[2 * count - 2]);
+        out.push_back(xy[2 * count - 1]);
+    }
+    return out;
+}
+
+std::vector<double> PathProcessing::smoothPath(const double* xy, size_t count, double distance, double step) {
+    std::vector<double> out;
+    if (count < 2 || step <= 0) {
+        return out;
+    }
+    distance = std::max(distance, 0.0);
+    const std::vector<double> cumulative = cumulativeLengths(xy, count);
+    const double total = cumulative.back();
+    if (distance >= total) {
+        return out;
+    }
+    out.reserve(2 * ((size_t)std::ceil((total - distance) / step) + 1));
+
+    // Both walkers only ever move forward, so each keeps its own segment cursor
+    PolylineCursor lead(xy, cumulative);
+    PolylineCursor trail(xy, cumulative);
+    double lead_x, lead_y, trail_x, trail_y;
+    for (size_t k = 0; distance + k * step < total; k++) {
+        lead.at(distance + k * step, lead_x, lead_y);
+        trail.at(k * step, trail_x, trail_y);
+        out.push_back((lead_x + trail_x) / 2);
+        out.push_back((lead_y + trail_y) / 2);
+    }
+    return out;
+}
+
+void PathProcessing::computePathData(const double* xy, size_t count, float* out) {
+    if (count < 2) {
+        return;
+    }
+    const size_t segments = count - 1;
+    const double kDegrees = 180.0 / 3.14159265358979323846;
+
+    // Each pass is a straight loop over contiguous arrays so the compiler can vectorise it
+    std::vector<double> dx(segments), dy(segments), length(segments), heading(segments);
+    for (size_t i = 0; i < segments; i++) {
+        dx[i] = xy[2 * i + 2] - xy[2 * i];
+        dy[i] = xy[2 * i + 3] - xy[2 * i + 1];
+    }
+    for (size_t i = 0; i < segments; i++) {
+        length[i] = std::sqrt(dx[i] * dx[i] + dy[i] * dy[i]);
+    }
+    for (size_t i = 0; i < segments; i++) {
+        heading[i] = std::atan2(dy[i], dx[i]) * kDegrees;
+    }
+
+    double distance = 0.0;
+    for (size_t i = 0; i < segments; i++) {
+        float* row = out + i * kPathDataColumns;
+        row[0] = (float)xy[2 * i];
+        row[1] = (float)xy[2 * i + 1];
+        row[3] = (float)(heading[i] < 0 ? heading[i] + 360.0 : heading[i]);
+        row[4] = (float)distance;
+        distance += length[i];
+    }
+
+    // Heading change wrapped to (-180, 180] over the mean length of the adjacent segments;
+    // the first point and the last row have no curvature
+    out[2] = 0.0f;
+    out[(segments - 1) * kPathDataColumns + 2] = 0.0f;
+    for (size_t i = 1; i + 1 < segments; i++) {
+        double change = heading[i] - heading[i - 1];
+        change = change > 180.0 ? change - 360.0 : change;
+        change = change <= -180.0 ? change + 360.0 : change;
+        const double mean_length = (length[i - 1] + length[i]) / 2;
+        out[i * kPathDataColumns + 2] = (float)(mean_length > 0 ? change / mean_length : 0.0);
+    }
+}
@@ -0,0 +1,30 @@
+#ifndef PATH_PROCESSING_H
+#define PATH_PROCESSING_H
+
+#include <vector>
+#include <cstddef>
+
+// Native counterparts of the per-point loops in path_processor.py. Paths are flat row-major
+// (x, y) arrays in cm.
+class PathProcessing {
+public:
+    // Points every `step` cm of arc length from the first waypoint; the last waypoint is
+    // appended when the length is not a multiple of `step`
+    static std::vector<double> resample(const double* xy, size_t count, double step);
+
+    // Midpoint of two walkers `distance` cm apart, both advancing `step` cm until the leading
+    // one reaches the end (same output as path_processor.smooth_path with 1 cm moves)
+    static std::vector<double> smoothPath(const double* xy, size_t count, double distance, double step = 1.0);
+
+    // Columns of path_data.npy for every point but the last: x, y, signed curvature
+    // (degrees/cm, 0 at both ends), heading to the next point (degrees in [0, 360)) and
+    // cumulative distance (cm). Writes (count - 1) rows of 5 floats into `out`.
+    static void computePathData(const double* xy, size_t count, float* out);
+
+    static constexpr size_t kPathDataColumns = 5;
+
+private:
+    static std::vector<double> cumulativeLengths(const double* xy, size_t count);
+};
+
+#endif // PATH_PROCESSING_H
@@ -1,8 +1,10 @@
+import ast
 import math
+import os
 import cv2
 import numpy as np
 import matplotlib.pyplot as plt
-from math import atan2, degrees
+import pathfinder  # Our C++ module
 
 # Global configuration
 CELL_SIZE = 5  # cm per grid cell
@@ -49,10 +51,17 @@ class PathWalker:
         return self.current_position
 
 def read_waypoints(file_path):
-    with open(file_path, 'r') as f:
-        content = f.read().strip()
-        waypoints = eval(content)
-        return [(x*CELL_SIZE, y*CELL_SIZE) for (x,y) in waypoints]
+    """Read grid waypoints written by astar.py and scale them to cm.
+    
+    Binary waypoint files are memory-mapped natively; legacy path.txt files holding a
+    Python list literal are still accepted.
+    """
+    if file_path.endswith('.txt'):
+        with open(file_path, 'r') as f:
+            waypoints = ast.literal_eval(f.read().strip())
+    else:
+        waypoints = pathfinder.read_path_file(file_path).tolist()
+    return [(x*CELL_SIZE, y*CELL_SIZE) for (x,y) in waypoints]
 
 def calculate_distance(p1, p2):
     return math.sqrt((p2[0]-p1[0])**2 + (p2[1]-p1[1])**2)
@@ -79,101 +88,28 @@ def process_path(waypoints):
 
 def smooth_path(segments, distance=50):
     """Generate smoothed path by averaging positions of two walkers"""
-    smoothed = []
-    lead = PathWalker(segments)
-    trail = PathWalker(segments)
-    
-    # Move leading walker ahead by specified distance
-    lead.move(distance)
-    
-    while lead.get_distance_traveled() < (segments[-1]['distance_from_start'] + segments[-1]['length']):
-        # Get current positions
-        lead_pos = np.array(lead.get_current_position())
-        trail_pos = np.array(trail.get_current_position())
-        
-        # Calculate and store median point
-        median = tuple((lead_pos + trail_pos) / 2)
-        smoothed.append(median)
-        
-        # Move both walkers forward
-        lead.move(1)
-        trail.move(1)
-    
-    return smoothed
+    # Same walker geometry as PathWalker, evaluated natively in one pass
+    waypoints = np.array([segment['start'] for segment in segments] + [segments[-1]['end']], dtype=np.float64)
+    return pathfinder.smooth_path(waypoints, distance, 1.0)
 
 def calculate_curvature(points):
     """Calculate curvature and heading for each point (except last)"""
-    curvatures = []
-    headings = []
-    distances = []
-    cumulative_distance = 0.0
+    points = np.asarray(points, dtype=np.float64)
+    path_data = pathfinder.compute_path_data(points)
     
-    # Calculate segment distances and cumulative distance
-    for i in range(1, len(points)):
-        dist = np.linalg.norm(np.array(points[i]) - np.array(points[i-1]))
-        distances.append(dist)
-        cumulative_distance += dist
-    
-    # Calculate heading and curvature for each point
-    for i in range(len(points)-1):
-        # Calculate heading to next point
-        curr_point = np.array(points[i])
-        next_point = np.array(points[i+1])
-        vec = next_point - curr_point
-        heading = degrees(atan2(vec[1], vec[0])) % 360
-        headings.append(heading)
-        
-        # Calculate curvature (except first and last points)
-        if 0 < i < len(points)-2:
-            prev_point = np.array(points[i-1])
-            vec1 = curr_point - prev_point
-            vec2 = next_point - curr_point
-            heading1 = atan2(vec1[1], vec1[0])
-            heading2 = atan2(vec2[1], vec2[0])
-            
-            angle_change = degrees(heading2 - heading1) % 360
-            if angle_change > 180:
-                angle_change -= 360
-            
-            avg_dist = (distances[i-1] + distances[i]) / 2
-            curvature = angle_change / avg_dist if avg_dist > 0 else 0
-            curvatures.append(curvature)
+    curvatures = path_data[1:-1, 2]  # Interior points only
+    headings = path_data[:, 3]
+    distances = np.hypot(*np.diff(points, axis=0).T)
     
     return curvatures, headings, distances
 
 def save_path_data(points, filename='path_data.npy'):
     """Save path data as numpy array with x,y,curvature,heading,distance"""
-    curvatures, headings, segment_distances = calculate_curvature(points)
-    
-    # Prepare data structure
-    path_data = []
-    cumulative_distance = 0.0
-    
-    for i in range(len(points)-1):  # Exclude last point since it has no next point
-        point = points[i]
-        if i == 0:
-            # First point has no curvature
-            curvature = 0.0
-        elif i < len(curvatures)+1:
-            curvature = curvatures[i-1]
-        else:
-            # Last point case (shouldn't happen due to range)
-            curvature = 0.0
-            
-        path_data.append([
-            point[0],  # x
-            point[1],  # y
-            curvature,
-            headings[i],
-            cumulative_distance
-        ])
-        
-        if i < len(segment_distances):
-            cumulative_distance += segment_distances[i]
-    
-    # Convert to numpy array and save
-    np.save(filename, np.array(path_data, dtype=np.float32))
-    return np.array(path_data)
+    points = np.asarray(points, dtype=np.float64)
+    path_data = np.empty((max(len(points) - 1, 0), 5), dtype=np.float32)
+    pathfinder.compute_path_data(points, path_data)
+    np.save(filename, path_data)
+    return path_data
 
 def plot_curvature_analysis(points, output_path='curvature_analysis.png'):
     """Plot curvature vs distance along path with moving averages"""
@@ -257,7 +193,7 @@ def plot_path(segments, output_path='path_visualization.png'):
         return False
 
 def main():
-    waypoints = read_waypoints('path.txt')
+    waypoints = read_waypoints('path.wpts' if os.path.exists('path.wpts') else 'path.txt')
     segments = process_path(waypoints)
     
     # Example usage of PathWalker
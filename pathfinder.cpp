@@ -1,43 +1,329 @@
 #include "pathfinder.h"
+#include "grid_pyramid.h"
+#include "quadtree.h"
+#include "tiled_map.h"
+#include "rolling_grid.h"
+#include "work_stealing_pool.h"
 #include <cmath>
 #include <queue>
-#include <unordered_map>
 #include <algorithm>
+#include <limits>
+#include <functional>
+#include <stdexcept>
+#include <chrono>
+#include <memory_resource>
+#include <type_traits>
 
-struct Node {
-    PathFinder::Point position;
-    Node* parent;
-    float g;  // Cost from start to current node
-    float h;  // Heuristic estimate to end
-    float f;  // Total cost (g + h)
-    
-    Node() : position({0,0}), parent(nullptr), g(0), h(0), f(0) {}  // Default constructor
-    Node(PathFinder::Point pos, Node* p = nullptr)
-        : position(pos), parent(p), g(0), h(0), f(0) {}
-        
-    bool operator==(const Node& other) const {
-        return position == other.position;
-    }
-    
-    bool operator<(const Node& other) const {
+// Open-list entry; g and the parent live in the cell's record, so an entry is just the
+// cell and its priority
+struct OpenEntry {
+    float f;  // g + heuristic when pushed
+    int x, y;
+
+    bool operator<(const OpenEntry& other) const {
         return f > other.f;  // For min-heap
     }
 };
 
-namespace std {
-    template<>
-    struct hash<PathFinder::Point> {
-        size_t operator()(const PathFinder::Point& p) const {
-            return hash<int>()(p.first) ^ (hash<int>()(p.second) << 1);
+// Search state of one cell, 12 bytes. The parent is stored as an offset from the cell, which
+// fits 32 bits on any map coordinates can address; (0, 0) marks the start.
+struct CellRecord {
+    float g;  // Cost from start, +infinity until reached
+    int32_t parent_dx, parent_dy;
+};
+
+// Bump allocator behind every container of a search. Deallocation is a no-op; reset()
+// rewinds to the first chunk but keeps all of them, so a warm context serves a query
+// without touching malloc.
+class SearchArena : public std::pmr::memory_resource {
+public:
+    void reset() {
+        chunk_ = 0;
+        offset_ = 0;
+        allocations_ = 0;
+        chunk_allocations_ = 0;
+    }
+
+    uint64_t allocations() const { return allocations_; }
+    uint64_t chunkAllocations() const { return chunk_allocations_; }
+
+    size_t capacity() const {
+        size_t total = 0;
+        for (const Chunk& chunk : chunks_) {
+            total += chunk.size;
+        }
+        return total;
+    }
+
+private:
+    struct Chunk {
+        std::unique_ptr<unsigned char[]> data;
+        size_t size;
+    };
+
+    static constexpr size_t kFirstChunk = 64 * 1024;
+
+    void* do_allocate(size_t bytes, size_t alignment) override {
+        allocations_++;
+        for (;;) {
+            if (chunk_ < chunks_.size()) {
+                Chunk& chunk = chunks_[chunk_];
+                const uintptr_t base = (uintptr_t)chunk.data.get();
+                const uintptr_t start = (base + offset_ + alignment - 1) & ~(uintptr_t)(alignment - 1);
+                if (start + bytes <= base + chunk.size) {
+                    offset_ = start + bytes - base;
+                    return (void*)start;
+                }
+                chunk_++;
+                offset_ = 0;
+                continue;
+            }
+            // Chunks double, so a query that outgrows the arena mallocs O(log size) times
+            const size_t size = std::max(bytes + alignment, chunks_.empty() ? kFirstChunk : 2 * chunks_.back().size);
+            chunks_.push_back({std::unique_ptr<unsigned char[]>(new unsigned char[size]), size});
+            chunk_allocations_++;
+            chunk_ = chunks_.size() - 1;
+        }
+    }
+
+    void do_deallocate(void*, size_t, size_t) override {}
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+
+    std::vector<Chunk> chunks_;
+    size_t chunk_ = 0;
+    size_t offset_ = 0;
+    uint64_t allocations_ = 0;
+    uint64_t chunk_allocations_ = 0;
+};
+
+struct OpenList : std::priority_queue<OpenEntry, std::pmr::vector<OpenEntry>> {
+    explicit OpenList(std::pmr::memory_resource* resource)
+        : std::priority_queue<OpenEntry, std::pmr::vector<OpenEntry>>(std::less<OpenEntry>(),
+                                                                        std::pmr::vector<OpenEntry>(resource)) {}
+};
+
+// Per-cell records and closed bits of a map, in 64x64 pages allocated from the arena the
+// first time the search reaches them. A two-level directory (page rows, then pages) keeps
+// setup proportional to the map height, so huge tiled maps cost only what the search touches.
+class CellStates {
+public:
+    static constexpr int kShift = 6;
+    static constexpr int kSize = 1 << kShift;
+    static constexpr int kMask = kSize - 1;
+
+    struct Page {
+        uint64_t closed[kSize];  // bit y & kMask of word x & kMask
+        CellRecord records[kSize * kSize];
+    };
+
+    // A cell inside its page
+    struct Cell {
+        Page* page;
+        int x, y;  // offsets within the page
+
+        CellRecord& record() const { return page->records[(x << kShift) | y]; }
+        bool closed() const { return (page->closed[x] >> y) & 1; }
+        void close() const { page->closed[x] |= uint64_t(1) << y; }
+    };
+
+    CellStates(int rows, int cols, std::pmr::memory_resource* arena)
+        : arena_(arena), page_rows_(((size_t)rows + kMask) >> kShift), page_cols_(((size_t)cols + kMask) >> kShift),
+          directory_(allocateZeroed<Page**>(page_rows_)) {}
+
+    Cell at(int x, int y) {
+        Page**& row = directory_[x >> kShift];
+        if (!row) {
+            row = allocateZeroed<Page*>(page_cols_);
+        }
+        Page*& page = row[y >> kShift];
+        if (!page) {
+            page = new (arena_->allocate(sizeof(Page), alignof(Page))) Page;
+            std::fill(page->closed, page->closed + kSize, 0);
+            std::fill(page->records, page->records + kSize * kSize,
+                      CellRecord{std::numeric_limits<float>::infinity(), 0, 0});
+        }
+        return {page, x & kMask, y & kMask};
+    }
+
+    // Records of the cell and its neighbours in the rows above and below, if their page exists
+    void prefetch(int x, int y) const {
+        Page** row = directory_[x >> kShift];
+        const Page* page = row ? row[y >> kShift] : nullptr;
+        if (page) {
+            const CellRecord* record = &page->records[((x & kMask) << kShift) | (y & kMask)];
+            __builtin_prefetch(record);
+            __builtin_prefetch(record - kSize);
+            __builtin_prefetch(record + kSize);
+        }
+    }
+
+private:
+    template <typename T>
+    T* allocateZeroed(size_t count) {
+        T* data = static_cast<T*>(arena_->allocate(count * sizeof(T), alignof(T)));
+        std::fill(data, data + count, nullptr);
+        return data;
+    }
+
+    std::pmr::memory_resource* arena_;
+    size_t page_rows_, page_cols_;
+    Page*** directory_;
+};
+
+struct SearchContainers {
+    SearchContainers(int rows, int cols, std::pmr::memory_resource* resource)
+        : open_list(resource), cells(rows, cols, resource) {}
+
+    OpenList open_list;
+    CellStates cells;
+};
+
+// The containers live in the arena and are abandoned rather than destroyed when it is
+// reset, which is only sound while nothing in them has a destructor to run
+static_assert(std::is_trivially_destructible<OpenEntry>::value, "OpenEntry must be trivially destructible");
+static_assert(std::is_trivially_destructible<CellStates>::value, "CellStates must be trivially destructible");
+
+struct PathFinder::SearchContext::State {
+    SearchArena arena;
+
+    // Fresh containers for one search; everything the previous search built is dropped in O(1)
+    SearchContainers& begin(int rows, int cols) {
+        arena.reset();
+        return *new (arena.allocate(sizeof(SearchContainers), alignof(SearchContainers)))
+            SearchContainers(rows, cols, &arena);
+    }
+};
+
+PathFinder::SearchContext::SearchContext() : state_(new State) {}
+PathFinder::SearchContext::~SearchContext() = default;
+PathFinder::SearchContext::SearchContext(SearchContext&&) noexcept = default;
+PathFinder::SearchContext& PathFinder::SearchContext::operator=(SearchContext&&) noexcept = default;
+
+namespace {
+
+// Map interface of search() over an in-memory grid
+class GridView {
+public:
+    explicit GridView(const PathFinder::Grid& grid)
+        : grid_(grid), rows_((int)grid.size()), cols_(grid.empty() ? 0 : (int)grid[0].size()) {}
+
+    int rows() const { return rows_; }
+    int cols() const { return cols_; }
+    bool blocked(int x, int y) const { return grid_[x][y] != 0; }
+
+    // The cell and its neighbours in the rows above and below (each row is its own allocation)
+    void prefetch(int x, int y) const {
+        __builtin_prefetch(grid_[x].data() + y);
+        if (x > 0) {
+            __builtin_prefetch(grid_[x - 1].data() + y);
+        }
+        if (x + 1 < rows_) {
+            __builtin_prefetch(grid_[x + 1].data() + y);
+        }
+    }
+
+private:
+    const PathFinder::Grid& grid_;
+    int rows_, cols_;
+};
+
+// Possible movement directions (4-way)
+const PathFinder::Point kDirections[] = {{0, 1}, {1, 0}, {0, -1}, {-1, 0}};
+
+// Cells visited walking from a to b, in the same order as PathFinder::lineOfSight
+template <typename Visit>
+void forEachCellOnLine(const PathFinder::Point& a, const PathFinder::Point& b, Visit&& visit) {
+    int dx = abs(b.first - a.first);
+    int dy = abs(b.second - a.second);
+    int x = a.first;
+    int y = a.second;
+    int n = 1 + dx + dy;
+    const int x_inc = (b.first > a.first) ? 1 : -1;
+    const int y_inc = (b.second > a.second) ? 1 : -1;
+    int error = dx - dy;
+    dx *= 2;
+    dy *= 2;
+    for (int i = 0; i < n; i++) {
+        visit(x, y);
+        if (error > 0) {
+            x += x_inc;
+            error -= dy;
+        } else if (error < 0) {
+            y += y_inc;
+            error += dx;
+        } else {
+            x += x_inc;
+            y += y_inc;
+            error -= dy;
+            error += dx;
+            n--;
+        }
+    }
+}
+
+// Full-resolution mask of the coarse cells within `radius` of a coarse path
+void markCorridor(const PathFinder::Path& coarse_path, const PathFinder::Grid& coarse, int factor, int radius,
+                  int rows, int cols, std::vector<uint8_t>& corridor) {
+    const int coarse_rows = (int)coarse.size();
+    const int coarse_cols = (int)coarse[0].size();
+    std::vector<uint8_t> mask((size_t)coarse_rows * coarse_cols, 0);
+    auto mark = [&](int cx, int cy) {
+        for (int x = std::max(cx - radius, 0); x <= std::min(cx + radius, coarse_rows - 1); x++) {
+            for (int y = std::max(cy - radius, 0); y <= std::min(cy + radius, coarse_cols - 1); y++) {
+                mask[(size_t)x * coarse_cols + y] = 1;
+            }
         }
     };
+    mark(coarse_path[0].first, coarse_path[0].second);
+    for (size_t i = 1; i < coarse_path.size(); i++) {
+        forEachCellOnLine(coarse_path[i - 1], coarse_path[i], mark);
+    }
+
+    corridor.assign((size_t)rows * cols, 0);
+    for (int x = 0; x < rows; x++) {
+        const uint8_t* coarse_row = mask.data() + (size_t)(x / factor) * coarse_cols;
+        uint8_t* row = corridor.data() + (size_t)x * cols;
+        for (int y = 0; y < cols; y++) {
+            row[y] = coarse_row[y / factor];
+        }
+    }
+}
+
+// Where a route leaving leaf `from` at `position` crosses into the edge-adjacent leaf `to`:
+// the last cell inside `from` and the first inside `to`, as close to `position` as the
+// shared edge allows
+void portal(const QuadTree::Leaf& from, const QuadTree::Leaf& to, const PathFinder::Point& position,
+            PathFinder::Point& exit, PathFinder::Point& enter) {
+    if (to.x + to.size == from.x || to.x == from.x + from.size) {
+        const int lo = std::max(from.y, to.y);
+        const int hi = std::min(from.y + from.size, to.y + to.size) - 1;
+        const int y = std::min(std::max(position.second, lo), hi);
+        const bool above = to.x + to.size == from.x;
+        exit = {above ? from.x : from.x + from.size - 1, y};
+        enter = {above ? from.x - 1 : to.x, y};
+    } else {
+        const int lo = std::max(from.x, to.x);
+        const int hi = std::min(from.x + from.size, to.x + to.size) - 1;
+        const int x = std::min(std::max(position.first, lo), hi);
+        const bool left = to.y + to.size == from.y;
+        exit = {x, left ? from.y : from.y + from.size - 1};
+        enter = {x, left ? from.y - 1 : to.y};
+    }
 }
 
+}  // namespace
+
 float PathFinder::heuristic(const Point& a, const Point& b) {
     return sqrtf(powf(a.first - b.first, 2) + powf(a.second - b.second, 2));
 }
 
-bool PathFinder::lineOfSight(const Grid& grid, const Point& a, const Point& b) {
+bool PathFinder::lineOfSight(const Grid& grid, const Point& a, const Point& b, SearchTrace* trace) {
+    return traceLine(GridView(grid), a, b, trace);
+}
+
+template <typename Map>
+bool PathFinder::traceLine(const Map& map, const Point& a, const Point& b, SearchTrace* trace) {
     int x1 = a.first, y1 = a.second;
     int x2 = b.first, y2 = b.second;
     
@@ -51,15 +337,21 @@ bool PathFinder::lineOfSight(const Grid& grid, const Point& a, const Point& b) {
     int error = dx - dy;
     dx *= 2;
     dy *= 2;
+    if (trace) {
+        trace->total_los_checks++;
+    }
     
     for (int i = 0; i < n; i++) {
         // Check grid bounds
-        if (x < 0 || x >= (int)grid.size() || y < 0 || y >= (int)grid[0].size()) {
+        if (x < 0 || x >= map.rows() || y < 0 || y >= map.cols()) {
             return false;
         }
+        if (trace) {
+            trace->los_checks[(size_t)x * trace->cols + y]++;
+        }
         
         // Check if current cell is blocked
-        if (grid[x][y] != 0) {
+        if (map.blocked(x, y)) {
             return false;
         }
         
@@ -81,89 +373,478 @@ bool PathFinder::lineOfSight(const Grid& grid, const Point& a, const Point& b) {
     return true;
 }
 
+// One Theta* query as a state machine: each step() pops one open-list entry, so several
+// queries can take turns on one thread
+template <typename Map>
+class PathFinder::SearchRun {
+public:
+    SearchRun(const Map& map, const Point& start, const Point& end, const SearchOptions& options,
+              SearchContext& context)
+        : map_(map), end_(end), options_(options), state_(*context.state_), containers_(state_.begin(map.rows(), map.cols())),
+          started_(std::chrono::steady_clock::now()) {
+        SearchTrace* trace = options.trace;
+        if (trace) {
+            trace->rows = map.rows();
+            trace->cols = map.cols();
+            trace->expansions.assign((size_t)trace->rows * trace->cols, 0);
+            trace->los_checks.assign((size_t)trace->rows * trace->cols, 0);
+            trace->total_expansions = 0;
+            trace->total_los_checks = 0;
+        }
+
+        // A start off the map has no cell to hold its state; the first step() finds the open
+        // list empty
+        if (start.first >= 0 && start.first < map.rows() && start.second >= 0 && start.second < map.cols()) {
+            containers_.cells.at(start.first, start.second).record() = CellRecord{0.0f, 0, 0};
+            containers_.open_list.push({heuristic(start, end), start.first, start.second});
+        }
+    }
+
+    // Advances the search by one expansion; false once it has finished
+    bool step();
+
+    // Requests the cells the next step() starts with, so a caller interleaving several runs
+    // has them arriving while it works on the others
+    void prefetch() const {
+        if (!containers_.open_list.empty()) {
+            const OpenEntry& next = containers_.open_list.top();
+            map_.prefetch(next.x, next.y);
+            containers_.cells.prefetch(next.x, next.y);
+        }
+    }
+
+    // The path once step() has returned false; empty when none was found
+    Path& path() { return path_; }
+
+private:
+    void finish(bool cancelled) {
+        if (options_.stats) {
+            SearchStats* stats = options_.stats;
+            stats->expansions = expansions_;
+            stats->los_checks = los_checks_;
+            stats->cancelled = cancelled;
+            stats->seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started_).count();
+            stats->allocations = state_.arena.allocations();
+            stats->heap_allocations = state_.arena.chunkAllocations();
+            stats->arena_bytes = state_.arena.capacity();
+        }
+    }
+
+    const Map& map_;
+    const Point end_;
+    const SearchOptions& options_;
+    SearchContext::State& state_;
+    SearchContainers& containers_;
+    Path path_;
+
+    // Counted unconditionally; copied out when the search finishes
+    uint64_t expansions_ = 0;
+    uint64_t los_checks_ = 0;
+    const std::chrono::steady_clock::time_point started_;
+};
+
+template <typename Map>
+bool PathFinder::SearchRun<Map>::step() {
+    OpenList& open_list = containers_.open_list;
+    CellStates& cells = containers_.cells;
+    SearchTrace* trace = options_.trace;
+    const uint8_t* corridor = options_.corridor;
+
+    if (open_list.empty()) {
+        finish(false);  // Empty path if none found
+        return false;
+    }
+    // A relaxed load of an uncontended flag, cheap enough to check on every expansion
+    if (options_.cancel && options_.cancel->cancelled()) {
+        finish(true);
+        return false;
+    }
+    expansions_++;
+    const OpenEntry entry = open_list.top();
+    open_list.pop();
+    const Point position(entry.x, entry.y);
+    if (trace) {
+        trace->expansions[(size_t)position.first * trace->cols + position.second]++;
+        trace->total_expansions++;
+    }
+
+    // Skip if already processed. Entries are only pushed when they improve a cell's g, so the
+    // first one popped for a cell is the one its record holds.
+    const CellStates::Cell cell = cells.at(position.first, position.second);
+    if (cell.closed()) {
+        return true;
+    }
+    cell.close();
+
+    // Found the goal
+    if (position == end_) {
+        // Sized up front so the returned path is the query's only malloc once the arena is warm
+        auto parentOf = [&](const Point& p, Point& parent) {
+            const CellRecord& record = cells.at(p.first, p.second).record();
+            parent = Point(p.first + record.parent_dx, p.second + record.parent_dy);
+            return record.parent_dx || record.parent_dy;
+        };
+        size_t length = 1;
+        for (Point p = position; parentOf(p, p);) {
+            length++;
+        }
+        path_.resize(length);
+        Point p = position;
+        path_[--length] = p;
+        while (length > 0 && parentOf(p, p)) {
+            path_[--length] = p;
+        }
+        finish(false);
+        return false;
+    }
+
+    const CellRecord current = cell.record();
+    const bool has_parent = current.parent_dx || current.parent_dy;
+    const Point parent(position.first + current.parent_dx, position.second + current.parent_dy);
+
+    // Generate children
+    for (const auto& dir : kDirections) {
+        Point node_position(
+            position.first + dir.first,
+            position.second + dir.second
+        );
+
+        // Check bounds
+        if (node_position.first < 0 || node_position.first >= map_.rows() ||
+            node_position.second < 0 || node_position.second >= map_.cols()) {
+            continue;
+        }
+
+        // Check walkable
+        if (map_.blocked(node_position.first, node_position.second)) {
+            continue;
+        }
+        if (corridor && !corridor[(size_t)node_position.first * map_.cols() + node_position.second]) {
+            continue;
+        }
+
+        // Calculate costs
+        const int to_parent_x = parent.first - node_position.first;
+        const int to_parent_y = parent.second - node_position.second;
+        bool visible = false;
+        if (has_parent) {
+            los_checks_++;
+            visible = traceLine(map_, parent, node_position, trace);
+        }
+        CellRecord next;
+        if (visible) {
+            // Theta*: try to connect to grandparent
+            next.g = cells.at(parent.first, parent.second).record().g + heuristic(parent, node_position);
+            next.parent_dx = to_parent_x;
+            next.parent_dy = to_parent_y;
+        } else {
+            // Regular A*
+            next.g = current.g + 1;
+            next.parent_dx = -dir.first;
+            next.parent_dy = -dir.second;
+        }
+
+        // Add to open list if better path found
+        CellRecord& record = cells.at(node_position.first, node_position.second).record();
+        if (next.g < record.g) {
+            record = next;
+            open_list.push({next.g + heuristic(node_position, end_), node_position.first, node_position.second});
+        }
+    }
+    return true;
+}
+
+template <typename Map>
+PathFinder::Path PathFinder::search(const Map& map, const Point& start, const Point& end,
+                                    const SearchOptions& options) {
+    // Containers come from the caller's context when there is one, emptied but with their
+    // capacity intact
+    std::unique_ptr<SearchContext> local_context;
+    SearchContext* context = options.context;
+    if (!context) {
+        local_context.reset(new SearchContext);
+        context = local_context.get();
+    }
+    SearchRun<Map> run(map, start, end, options, *context);
+    while (run.step()) {
+    }
+    return std::move(run.path());
+}
+
 PathFinder::Path PathFinder::findPath(const Grid& grid, const Point& start, const Point& end) {
-    // Create start and end nodes
-    Node start_node(start);
-    Node end_node(end);
-    
-    // Priority queue for open list
-    std::priority_queue<Node> open_list;
-    open_list.push(start_node);
-    
-    // Closed list
-    std::unordered_set<Point> closed_list;
-    
-    // Possible movement directions (4-way)
-    const std::vector<Point> directions = {{0, 1}, {1, 0}, {0, -1}, {-1, 0}};
-    
-    // Node storage and lookup
-    std::unordered_map<Point, Node> node_map;
-    node_map[start] = start_node;
-    
+    return findPath(grid, start, end, SearchOptions());
+}
+
+PathFinder::Path PathFinder::findPath(const Grid& grid, const Point& start, const Point& end, SearchTrace* trace) {
+    SearchOptions options;
+    options.trace = trace;
+    return findPath(grid, start, end, options);
+}
+
+PathFinder::Path PathFinder::findPath(const Grid& grid, const Point& start, const Point& end,
+                                      const SearchOptions& options) {
+    return search(GridView(grid), start, end, options);
+}
+
+std::vector<PathFinder::Path> PathFinder::findPaths(const Grid& grid, const std::vector<Query>& queries,
+                                                    WorkStealingPool& pool) {
+    // Workers only touch their own context and buffer while the batch runs
+    std::vector<SearchContext> contexts(pool.size());
+    std::vector<std::vector<std::pair<size_t, Path>>> buffers(pool.size());
+    const GridView view(grid);
+    pool.parallelFor(queries.size(), [&](size_t index, size_t worker) {
+        SearchOptions options;
+        options.context = &contexts[worker];
+        buffers[worker].emplace_back(index, search(view, queries[index].first, queries[index].second, options));
+    });
+
+    std::vector<Path> paths(queries.size());
+    for (auto& buffer : buffers) {
+        for (auto& result : buffer) {
+            paths[result.first] = std::move(result.second);
+        }
+    }
+    return paths;
+}
+
+std::vector<PathFinder::Path> PathFinder::findPathsInterleaved(const Grid& grid, const std::vector<Query>& queries,
+                                                               size_t lanes) {
+    lanes = std::max<size_t>(std::min(lanes, queries.size()), 1);
+    const GridView view(grid);
+    const SearchOptions options;
+    std::vector<SearchContext> contexts(lanes);
+    std::vector<std::unique_ptr<SearchRun<GridView>>> runs(lanes);
+    std::vector<size_t> query_of(lanes);
+    std::vector<Path> paths(queries.size());
+
+    size_t next = 0;
+    size_t active = 0;
+    for (size_t lane = 0; lane < lanes && next < queries.size(); lane++, next++) {
+        runs[lane].reset(new SearchRun<GridView>(view, queries[next].first, queries[next].second, options,
+                                                 contexts[lane]));
+        query_of[lane] = next;
+        active++;
+    }
+    while (active > 0) {
+        for (size_t lane = 0; lane < lanes; lane++) {
+            SearchRun<GridView>* run = runs[lane].get();
+            if (!run) {
+                continue;
+            }
+            if (run->step()) {
+                run->prefetch();
+                continue;
+            }
+            // The lane's context is rewound for its next query, so the finished run goes first
+            paths[query_of[lane]] = std::move(run->path());
+            runs[lane].reset();
+            if (next < queries.size()) {
+                runs[lane].reset(new SearchRun<GridView>(view, queries[next].first, queries[next].second, options,
+                                                         contexts[lane]));
+                query_of[lane] = next++;
+                runs[lane]->prefetch();
+            } else {
+                active--;
+            }
+        }
+    }
+    return paths;
+}
+
+PathFinder::Path PathFinder::findPath(const TiledMap& map, const Point& start, const Point& end) {
+    // The view pins tiles for the duration of this one query
+    const TiledMap::View view(map);
+    return search(view, start, end, SearchOptions());
+}
+
+PathFinder::Path PathFinder::findPath(const RollingGrid& window, const Point& start, const Point& end) {
+    return search(window, start, end, SearchOptions());
+}
+
+PathFinder::Path PathFinder::findPathCoarseToFine(const Grid& grid, const GridPyramid& pyramid, const Point& start,
+                                                  const Point& end, int corridor_radius) {
+    const int rows = (int)grid.size();
+    const int cols = rows > 0 ? (int)grid[0].size() : 0;
+    if (pyramid.rows() != rows || pyramid.cols() != cols) {
+        throw std::invalid_argument("Pyramid was built for a different grid size");
+    }
+
+    std::vector<uint8_t> corridor;
+    for (size_t i = pyramid.levels(); i-- > 0;) {
+        const Grid& coarse = pyramid.level(i);
+        const int factor = pyramid.factor(i);
+        const Point coarse_start(start.first / factor, start.second / factor);
+        const Point coarse_end(end.first / factor, end.second / factor);
+        auto open = [&](const Point& p) {
+            return p.first >= 0 && p.first < (int)coarse.size() && p.second >= 0 &&
+                   p.second < (int)coarse[0].size() && coarse[p.first][p.second] == 0;
+        };
+        // Blocks touching a wall are blocked on the coarse level; try a finer one
+        if (!open(coarse_start) || !open(coarse_end)) {
+            continue;
+        }
+        const Path coarse_path = findPath(coarse, coarse_start, coarse_end);
+        if (coarse_path.empty()) {
+            continue;
+        }
+
+        markCorridor(coarse_path, coarse, factor, corridor_radius, rows, cols, corridor);
+        SearchOptions options;
+        options.corridor = corridor.data();
+        Path path = findPath(grid, start, end, options);
+        if (!path.empty()) {
+            return path;
+        }
+    }
+    return findPath(grid, start, end);
+}
+
+PathFinder::Path PathFinder::findPathQuadTree(const Grid& grid, const QuadTree& tree, const Point& start,
+                                              const Point& end) {
+    const int rows = (int)grid.size();
+    const int cols = rows > 0 ? (int)grid[0].size() : 0;
+    if (tree.rows() != rows || tree.cols() != cols) {
+        throw std::invalid_argument("Quadtree was built for a different grid size");
+    }
+    const int start_leaf = tree.leafAt(start.first, start.second);
+    const int goal_leaf = tree.leafAt(end.first, end.second);
+    if (start_leaf < 0 || goal_leaf < 0) {
+        return {};
+    }
+
+    // A* over leaves; each leaf is entered once, at the point its best route crosses into it
+    const size_t leaves = tree.leafCount();
+    std::vector<float> g(leaves, std::numeric_limits<float>::infinity());
+    std::vector<int> came_from(leaves, -1);
+    std::vector<Point> exit_from(leaves), entry(leaves);
+    std::vector<char> closed(leaves, 0);
+    using Entry = std::pair<float, int>;
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> open_list;
+
+    g[start_leaf] = 0.0f;
+    entry[start_leaf] = start;
+    open_list.push({heuristic(start, end), start_leaf});
     while (!open_list.empty()) {
-        Node current_node = open_list.top();
+        const int current = open_list.top().second;
         open_list.pop();
-        
-        // Skip if already processed
-        if (closed_list.count(current_node.position)) {
+        if (closed[current]) {
             continue;
         }
-        closed_list.insert(current_node.position);
-        
-        // Found the goal
-        if (current_node == end_node) {
-            Path path;
-            Node* current = &current_node;
-            while (current != nullptr) {
-                path.push_back(current->position);
-                current = current->parent;
+        closed[current] = 1;
+        if (current == goal_leaf) {
+            break;
+        }
+        for (const int* it = tree.neighboursBegin(current); it != tree.neighboursEnd(current); ++it) {
+            const int next = *it;
+            if (closed[next]) {
+                continue;
+            }
+            Point exit, enter;
+            portal(tree.leaf(current), tree.leaf(next), entry[current], exit, enter);
+            const float cost = g[current] + heuristic(entry[current], exit) + 1.0f;
+            if (cost < g[next]) {
+                g[next] = cost;
+                came_from[next] = current;
+                exit_from[next] = exit;
+                entry[next] = enter;
+                open_list.push({cost + heuristic(enter, end), next});
             }
-            std::reverse(path.begin(), path.end());
-            return path;
         }
-        
-        // Generate children
+    }
+    if (!closed[goal_leaf]) {
+        return {};
+    }
+
+    // Every consecutive pair is either inside one leaf (a free square) or two adjacent cells,
+    // so the raw route is collision-free before it is straightened
+    Path route{end};
+    for (int leaf = goal_leaf; leaf != start_leaf; leaf = came_from[leaf]) {
+        route.push_back(entry[leaf]);
+        route.push_back(exit_from[leaf]);
+    }
+    route.push_back(start);
+    std::reverse(route.begin(), route.end());
+    route.erase(std::unique(route.begin(), route.end()), route.end());
+
+    Path path{route[0]};
+    size_t anchor = 0;
+    for (size_t i = 2; i < route.size(); i++) {
+        if (!lineOfSight(grid, route[anchor], route[i])) {
+            anchor = i - 1;
+            path.push_back(route[anchor]);
+        }
+    }
+    if (route.size() > 1) {
+        path.push_back(route.back());
+    }
+    return path;
+}
+
+std::vector<float> PathFinder::distanceField(const Grid& grid, const Point& goal) {
+    const int rows = (int)grid.size();
+    const int cols = rows > 0 ? (int)grid[0].size() : 0;
+    std::vector<float> dist((size_t)rows * cols, std::numeric_limits<float>::infinity());
+    if (goal.first < 0 || goal.first >= rows || goal.second < 0 || goal.second >= cols ||
+        grid[goal.first][goal.second] != 0) {
+        return dist;
+    }
+
+    // Backward Theta* without a heuristic: every settled cell keeps the any-angle
+    // parent it would use on its way to the goal.
+    std::vector<int> parent((size_t)rows * cols, -1);
+    std::vector<char> closed((size_t)rows * cols, 0);
+    using Entry = std::pair<float, int>;
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> open_list;
+
+    const int goal_idx = goal.first * cols + goal.second;
+    dist[goal_idx] = 0.0f;
+    open_list.push({0.0f, goal_idx});
+
+    const std::vector<Point> directions = {{0, 1}, {1, 0}, {0, -1}, {-1, 0}};
+
+    while (!open_list.empty()) {
+        const int idx = open_list.top().second;
+        open_list.pop();
+        if (closed[idx]) {
+            continue;
+        }
+        closed[idx] = 1;
+
+        const Point current(idx / cols, idx % cols);
+        const int parent_idx = parent[idx];
+        const Point parent_pos(parent_idx / cols, parent_idx % cols);
+
         for (const auto& dir : directions) {
-            Point node_position(
-                current_node.position.first + dir.first,
-                current_node.position.second + dir.second
-            );
-            
-            // Check bounds
-            if (node_position.first < 0 || node_position.first >= (int)grid.size() ||
-                node_position.second < 0 || node_position.second >= (int)grid[0].size()) {
+            Point node_position(current.first + dir.first, current.second + dir.second);
+            if (node_position.first < 0 || node_position.first >= rows ||
+                node_position.second < 0 || node_position.second >= cols) {
                 continue;
             }
-            
-            // Check walkable
             if (grid[node_position.first][node_position.second] != 0) {
                 continue;
             }
-            
-            // Create new node
-            Node new_node(node_position, &node_map[current_node.position]);
-            
-            // Calculate costs
-            if (current_node.parent && lineOfSight(grid, current_node.parent->position, node_position)) {
-                // Theta*: try to connect to grandparent
-                new_node.g = current_node.parent->g + heuristic(current_node.parent->position, node_position);
-                new_node.parent = current_node.parent;
+            const int node_idx = node_position.first * cols + node_position.second;
+            if (closed[node_idx]) {
+                continue;
+            }
+
+            float g;
+            int new_parent;
+            if (parent_idx >= 0 && lineOfSight(grid, parent_pos, node_position)) {
+                g = dist[parent_idx] + heuristic(parent_pos, node_position);
+                new_parent = parent_idx;
             } else {
-                // Regular A*
-                new_node.g = current_node.g + 1;
+                g = dist[idx] + 1;
+                new_parent = idx;
             }
-            
-            new_node.h = heuristic(node_position, end);
-            new_node.f = new_node.g + new_node.h;
-            
-            // Add to open list if better path found
-            if (!node_map.count(node_position) || new_node.g < node_map[node_position].g) {
-                node_map[node_position] = new_node;
-                open_list.push(new_node);
+
+            if (g < dist[node_idx]) {
+                dist[node_idx] = g;
+                parent[node_idx] = new_parent;
+                open_list.push({g, node_idx});
             }
         }
     }
-    
-    return {};  // Return empty path if none found
-}
 
+    return dist;
+}
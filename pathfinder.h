@@ -4,6 +4,15 @@
 #include <vector>
 #include <utility>  // for std::pair
 #include <unordered_set>
+#include <cstdint>
+#include <memory>
+#include <atomic>
+
+class GridPyramid;
+class QuadTree;
+class TiledMap;
+class RollingGrid;
+class WorkStealingPool;
 
 class PathFinder {
 public:
@@ -11,14 +20,127 @@ public:
     using Grid = std::vector<std::vector<int>>;
     using Path = std::vector<Point>;
 
+    // Per-cell search statistics for profiling a query, row-major (rows x cols)
+    struct SearchTrace {
+        int rows = 0;
+        int cols = 0;
+        std::vector<uint32_t> expansions;   // open-list pops, stale duplicates included
+        std::vector<uint32_t> los_checks;   // line-of-sight traces that visited the cell
+        uint64_t total_expansions = 0;
+        uint64_t total_los_checks = 0;      // lineOfSight calls
+    };
+
+    // Set from any thread to stop searches that were given it; they return an empty path
+    // before their next expansion
+    class CancellationToken {
+    public:
+        void cancel() { cancelled_.store(true, std::memory_order_relaxed); }
+        bool cancelled() const { return cancelled_.load(std::memory_order_relaxed); }
+        void reset() { cancelled_.store(false, std::memory_order_relaxed); }
+
+    private:
+        std::atomic<bool> cancelled_{false};
+    };
+
+    // Counters of one search, filled in whether it finished, failed or was cancelled
+    struct SearchStats {
+        uint64_t expansions = 0;   // open-list pops, stale duplicates included
+        uint64_t los_checks = 0;   // line-of-sight traces
+        bool cancelled = false;
+        double seconds = 0.0;      // wall time of the search
+        uint64_t allocations = 0;       // container allocations, all served by the context's arena
+        uint64_t heap_allocations = 0;  // arena chunks malloc'ed by this search (0 once warm)
+        size_t arena_bytes = 0;         // memory the context's arena holds
+    };
+
+    // Arena that every container of a search allocates from. It is rewound in O(1) before
+    // each query and keeps its memory, so a thread running many queries stops calling malloc
+    // once its context has grown to the largest search. Not thread-safe: use one context per
+    // thread.
+    class SearchContext {
+    public:
+        SearchContext();
+        ~SearchContext();
+        SearchContext(SearchContext&&) noexcept;
+        SearchContext& operator=(SearchContext&&) noexcept;
+
+    private:
+        friend class PathFinder;
+        struct State;
+        std::unique_ptr<State> state_;
+    };
+
+    // Optional behaviour of a single search; the defaults give the plain Theta* search
+    struct SearchOptions {
+        SearchTrace* trace = nullptr;      // filled in (resized to the grid) when set
+        const uint8_t* corridor = nullptr; // row-major mask; cells that are 0 are not expanded
+        SearchContext* context = nullptr;  // reused search memory; a temporary one when null
+        const CancellationToken* cancel = nullptr;
+        SearchStats* stats = nullptr;      // overwritten when set
+    };
+
+    using Query = std::pair<Point, Point>;  // start, end
+
     // Core pathfinding function (Theta* variant)
     static Path findPath(const Grid& grid, const Point& start, const Point& end);
 
+    // findPath that also fills `trace` (resized to the grid); a null trace costs nothing
+    static Path findPath(const Grid& grid, const Point& start, const Point& end, SearchTrace* trace);
+
+    static Path findPath(const Grid& grid, const Point& start, const Point& end, const SearchOptions& options);
+
+    // Runs every query on `pool`. Workers steal queries from each other, so a few slow queries
+    // do not leave the other threads idle; each worker has its own search context and result
+    // buffer. Results are in query order.
+    static std::vector<Path> findPaths(const Grid& grid, const std::vector<Query>& queries, WorkStealingPool& pool);
+
+    // Theta* on a tiled out-of-core map; the tiles the search touches stay pinned until it
+    // returns
+    static Path findPath(const TiledMap& map, const Point& start, const Point& end);
+
+    // Theta* inside a rolling window; start, end and the path are in window-local coordinates
+    static Path findPath(const RollingGrid& window, const Point& start, const Point& end);
+
+    // Plans on the coarsest pyramid level that connects start and goal, then searches the
+    // full grid only inside a corridor of `corridor_radius` coarse cells around that path.
+    // Falls back to the next finer level, and finally to an unrestricted search, when a
+    // level fails. `pyramid` must have been built from `grid`.
+    static Path findPathCoarseToFine(const Grid& grid, const GridPyramid& pyramid, const Point& start,
+                                     const Point& end, int corridor_radius = 1);
+
+    // Searches the free leaves of `tree` (built from `grid`) instead of cells, crossing between
+    // leaves where they share an edge, then straightens the leaf route with line-of-sight
+    // checks. Far fewer nodes than findPath on open maps; paths are near-shortest, not exact.
+    static Path findPathQuadTree(const Grid& grid, const QuadTree& tree, const Point& start, const Point& end);
+
+    // Theta* cost-to-go from every cell to `goal`, row-major (grid.size() x grid[0].size()).
+    // Blocked and unreachable cells hold +infinity.
+    static std::vector<float> distanceField(const Grid& grid, const Point& goal);
+
 
 private:
     // Helper functions
     static float heuristic(const Point& a, const Point& b);
-    static bool lineOfSight(const Grid& grid, const Point& a, const Point& b);
+    static bool lineOfSight(const Grid& grid, const Point& a, const Point& b, SearchTrace* trace = nullptr);
+
+    // Search and line-of-sight over any map exposing rows(), cols() and blocked(x, y), so
+    // in-memory grids and tiled maps share one implementation
+    template <typename Map>
+    static Path search(const Map& map, const Point& start, const Point& end, const SearchOptions& options);
+    template <typename Map>
+    class SearchRun;
+
+    // Runs the queries on the calling thread, `lanes` at a time: the searches take turns
+    // expanding one node each, and every search prefetches the cells of its next expansion
+    // before yielding. Not exported: it measured slower than one query at a time with every
+    // lane count (64 queries on 3000x3000: 937 q/s sequential, 740 q/s with 16 lanes; long
+    // queries on 6000x6000: 10.1 vs 7.4 q/s), as the search is bound by the heap and
+    // line-of-sight work rather than memory latency. benchmark_interleaved.py re-checks it.
+    static std::vector<Path> findPathsInterleaved(const Grid& grid, const std::vector<Query>& queries,
+                                                  size_t lanes = 8);
+
+    template <typename Map>
+    static bool traceLine(const Map& map, const Point& a, const Point& b, SearchTrace* trace);
 };
 
 #endif // PATHFINDER_H
\ No newline at end of file
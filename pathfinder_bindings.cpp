@@ -1,9 +1,113 @@
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
+#include <pybind11/numpy.h>
+#include <stdexcept>
+#include <algorithm>
+#include <memory>
+#include <mutex>
 #include "pathfinder.h"
+#include "hybrid_astar.h"
+#include "dubins_table.h"
+#include "path_processing.h"
+#include "speed_profile.h"
+#include "navigator.h"
+#include "trajectory_channel.h"
+#include "path_file.h"
+#include "dynamic_edt.h"
+#include "costmap.h"
+#include "grid_pyramid.h"
+#include "quadtree.h"
+#include "tiled_map.h"
+#include "rolling_grid.h"
+#include "work_stealing_pool.h"
+#include "async_planner.h"
 
 namespace py = pybind11;
 
+namespace {
+
+using DoubleArray = py::array_t<double, py::array::c_style | py::array::forcecast>;
+
+// Hands a row-major vector over to NumPy without copying it
+template <typename T>
+py::array_t<T> toArray(std::vector<T>&& values, size_t columns) {
+    auto* owned = new std::vector<T>(std::move(values));
+    py::capsule free_when_done(owned, [](void* p) { delete reinterpret_cast<std::vector<T>*>(p); });
+    const size_t rows = owned->size() / columns;
+    return py::array_t<T>(
+        std::vector<py::ssize_t>{(py::ssize_t)rows, (py::ssize_t)columns},
+        std::vector<py::ssize_t>{(py::ssize_t)(columns * sizeof(T)), (py::ssize_t)sizeof(T)},
+        owned->data(), free_when_done);
+}
+
+void requireColumns(const py::array& array, py::ssize_t columns, const char* name) {
+    if (array.ndim() != 2 || array.shape(1) != columns) {
+        throw std::invalid_argument(std::string(name) + " must have shape (n, " + std::to_string(columns) + ")");
+    }
+}
+
+// Raw pointer into a caller-provided C-contiguous, writable (rows, columns) array of T
+template <typename T>
+T* writableRows(py::array& array, py::ssize_t rows, py::ssize_t columns, const char* name) {
+    if (!array.dtype().is(py::dtype::of<T>()) || !(array.flags() & py::array::c_style) || !array.writeable()) {
+        throw std::invalid_argument(std::string(name) + " must be a writable C-contiguous " +
+                                    std::string(py::str(py::dtype::of<T>())) + " array");
+    }
+    if (array.ndim() != 2 || array.shape(0) != rows || array.shape(1) != columns) {
+        throw std::invalid_argument(std::string(name) + " must have shape (" + std::to_string(rows) + ", " +
+                                    std::to_string(columns) + ")");
+    }
+    return static_cast<T*>(array.mutable_data());
+}
+
+PathFile::DType parseDType(const std::string& dtype) {
+    if (dtype == "int32") {
+        return PathFile::Int32;
+    }
+    if (dtype == "float32") {
+        return PathFile::Float32;
+    }
+    throw std::invalid_argument("dtype must be 'int32' or 'float32'");
+}
+
+// Converts `rows` to the writer's dtype and appends them
+void appendRows(PathFile::Writer& writer, const py::array& rows) {
+    if (writer.dtype() == PathFile::Int32) {
+        auto values = py::array_t<int32_t, py::array::c_style | py::array::forcecast>::ensure(rows);
+        requireColumns(values, (py::ssize_t)writer.columns(), "rows");
+        writer.append(values.data(), values.shape(0));
+    } else {
+        auto values = py::array_t<float, py::array::c_style | py::array::forcecast>::ensure(rows);
+        requireColumns(values, (py::ssize_t)writer.columns(), "rows");
+        writer.append(values.data(), values.shape(0));
+    }
+}
+
+using OccupancyArray = py::array_t<uint8_t, py::array::c_style | py::array::forcecast>;
+
+void requireShape(const py::array& array, py::ssize_t rows, py::ssize_t cols, const char* name) {
+    if (array.ndim() != 2 || array.shape(0) != rows || array.shape(1) != cols) {
+        throw std::invalid_argument(std::string(name) + " must have shape (" + std::to_string(rows) + ", " +
+                                    std::to_string(cols) + ")");
+    }
+}
+
+// Pools outlive single calls so threads are not respawned per batch; one per thread count
+WorkStealingPool& sharedPool(size_t threads) {
+    static std::mutex mutex;
+    static std::vector<std::pair<size_t, std::unique_ptr<WorkStealingPool>>> pools;
+    std::lock_guard<std::mutex> lock(mutex);
+    for (auto& entry : pools) {
+        if (entry.first == threads) {
+            return *entry.second;
+        }
+    }
+    pools.emplace_back(threads, std::unique_ptr<WorkStealingPool>(new WorkStealingPool(threads)));
+    return *pools.back().second;
+}
+
+}  // namespace
+
 PYBIND11_MODULE(pathfinder, m) {
     m.doc() = "Python bindings for Theta* pathfinding implementation";
 
@@ -14,5 +118,595 @@ PYBIND11_MODULE(pathfinder, m) {
             return py::make_iterator(v.begin(), v.end());
         }, py::keep_alive<0, 1>());
 
-    m.def("find_path", &PathFinder::findPath, "Theta* pathfinding algorithm");
-}
\ No newline at end of file
+    m.def("find_path", py::overload_cast<const PathFinder::Grid&, const PathFinder::Point&, const PathFinder::Point&>(
+              &PathFinder::findPath),
+          "Theta* pathfinding algorithm");
+
+    m.def("find_paths",
+          [](const PathFinder::Grid& grid, const std::vector<PathFinder::Query>& queries, size_t threads) {
+              WorkStealingPool& pool = sharedPool(threads);
+              py::gil_scoped_release release;
+              return PathFinder::findPaths(grid, queries, pool);
+          },
+          py::arg("grid"), py::arg("queries"), py::arg("threads") = 0,
+          "find_path for a list of (start, end) queries on a work-stealing thread pool "
+          "(threads=0: one per hardware thread); results are in query order");
+
+    py::class_<PathFinder::CancellationToken>(m, "CancellationToken")
+        .def(py::init<>())
+        .def("cancel", &PathFinder::CancellationToken::cancel,
+             "Stop searches using this token; safe to call from any thread")
+        .def("reset", &PathFinder::CancellationToken::reset)
+        .def_property_readonly("cancelled", &PathFinder::CancellationToken::cancelled);
+
+    py::class_<PathFinder::SearchStats>(m, "SearchStats")
+        .def(py::init<>())
+        .def_readonly("expansions", &PathFinder::SearchStats::expansions)
+        .def_readonly("los_checks", &PathFinder::SearchStats::los_checks)
+        .def_readonly("cancelled", &PathFinder::SearchStats::cancelled)
+        .def_readonly("seconds", &PathFinder::SearchStats::seconds)
+        .def_readonly("allocations", &PathFinder::SearchStats::allocations)
+        .def_readonly("heap_allocations", &PathFinder::SearchStats::heap_allocations)
+        .def_readonly("arena_bytes", &PathFinder::SearchStats::arena_bytes);
+
+    m.def("find_path_with_stats",
+          [](const PathFinder::Grid& grid, const PathFinder::Point& start, const PathFinder::Point& end,
+             const PathFinder::CancellationToken* cancel) {
+              PathFinder::SearchStats stats;
+              PathFinder::SearchOptions options;
+              options.cancel = cancel;
+              options.stats = &stats;
+              PathFinder::Path path;
+              {
+                  py::gil_scoped_release release;
+                  path = PathFinder::findPath(grid, start, end, options);
+              }
+              return py::make_tuple(path, stats);
+          },
+          py::arg("grid"), py::arg("start"), py::arg("end"), py::arg("cancel") = nullptr,
+          "find_path returning (path, SearchStats). Cancelling the token from another thread stops "
+          "the search with an empty path and stats.cancelled set.");
+
+    py::class_<PlanFuture, std::shared_ptr<PlanFuture>>(m, "PlanFuture")
+        .def_property_readonly("id", &PlanFuture::id)
+        .def("done", &PlanFuture::done)
+        .def("cancel", &PlanFuture::cancel,
+             "Stop the query at its next check (or before it starts); it finishes with an empty path")
+        .def_property_readonly("stats", &PlanFuture::stats, "SearchStats, valid once done()")
+        .def("result",
+             [](const PlanFuture& future, py::object timeout) {
+                 const double seconds = timeout.is_none() ? -1.0 : timeout.cast<double>();
+                 bool finished;
+                 {
+                     py::gil_scoped_release release;
+                     if (seconds < 0) {
+                         future.wait();
+                         finished = true;
+                     } else {
+                         finished = future.waitFor(seconds);
+                     }
+                 }
+                 if (!finished) {
+                     throw py::value_error("Query not finished within the timeout");
+                 }
+                 return future.get();
+             },
+             py::arg("timeout") = py::none(),
+             "Path of the finished query, blocking until it is done; raises the query's error. "
+             "ValueError if timeout (seconds) passes first.");
+
+    py::class_<AsyncPlanner>(m, "AsyncPlanner")
+        .def(py::init([](const PathFinder::Grid& grid, size_t threads) {
+                 return new AsyncPlanner(std::make_shared<const PathFinder::Grid>(grid), threads);
+             }),
+             py::arg("grid"), py::arg("threads") = 0,
+             "Background planner over a copy of grid with `threads` workers (0: one per hardware thread)")
+        .def("set_grid",
+             [](AsyncPlanner& planner, const PathFinder::Grid& grid) {
+                 planner.setGrid(std::make_shared<const PathFinder::Grid>(grid));
+             },
+             py::arg("grid"), "Plan later submissions on a copy of grid; queued queries keep their map")
+        .def("submit", &AsyncPlanner::submit, py::arg("start"), py::arg("end"), py::arg("notify") = false,
+             "Queue a find_path query and return its PlanFuture at once. With notify=True the future is "
+             "also reported by take_completed() and wakes fileno().")
+        .def("fileno", &AsyncPlanner::wakeupFd,
+             "eventfd that becomes readable while notified completions are waiting (for loop.add_reader)")
+        .def("take_completed", &AsyncPlanner::takeCompleted,
+             "Notified futures finished since the last call; clears the fileno() wakeup")
+        .def_property_readonly("pending", &AsyncPlanner::pending)
+        .def_property_readonly("threads", &AsyncPlanner::threads);
+
+    m.def("find_path_traced",
+          [](const PathFinder::Grid& grid, const PathFinder::Point& start, const PathFinder::Point& end) {
+              PathFinder::SearchTrace trace;
+              PathFinder::Path path = PathFinder::findPath(grid, start, end, &trace);
+              const size_t columns = std::max(trace.cols, 1);
+              return py::make_tuple(path, toArray(std::move(trace.expansions), columns),
+                                    toArray(std::move(trace.los_checks), columns));
+          },
+          py::arg("grid"), py::arg("start"), py::arg("end"),
+          "find_path that also returns per-cell (rows, cols) uint32 arrays of open-list expansions "
+          "and line-of-sight trace visits, as (path, expansions, los_checks)");
+
+    m.def("find_path_coarse_to_fine",
+          [](const PathFinder::Grid& grid, const PathFinder::Point& start, const PathFinder::Point& end,
+             py::object map_version, const std::vector<int>& factors, int corridor_radius) {
+              // Pyramids of the last few map versions stay cached across calls
+              static PyramidCache cache;
+              const bool cached = !map_version.is_none();
+              const uint64_t version = cached ? map_version.cast<uint64_t>() : 0;
+              py::gil_scoped_release release;
+              const std::shared_ptr<const GridPyramid> pyramid =
+                  cached ? cache.get(grid, version, factors) : std::make_shared<const GridPyramid>(grid, factors);
+              return PathFinder::findPathCoarseToFine(grid, *pyramid, start, end, corridor_radius);
+          },
+          py::arg("grid"), py::arg("start"), py::arg("end"), py::arg("map_version") = py::none(),
+          py::arg("factors") = std::vector<int>{4, 16}, py::arg("corridor_radius") = 1,
+          "Theta* on a max-pooled grid pyramid first, then on the full grid inside a corridor around the "
+          "coarse path, falling back to a full search. Pass the same map_version for an unchanged map to "
+          "reuse its pyramid.");
+
+    py::class_<QuadTree>(m, "QuadTree")
+        .def(py::init<const PathFinder::Grid&>(), py::arg("grid"), py::call_guard<py::gil_scoped_release>(),
+             "Free-space quadtree of an occupancy grid")
+        .def("leaves",
+             [](const QuadTree& tree) {
+                 std::vector<int32_t> rows;
+                 rows.reserve(3 * tree.leafCount());
+                 for (size_t i = 0; i < tree.leafCount(); i++) {
+                     const QuadTree::Leaf& leaf = tree.leaf(i);
+                     rows.insert(rows.end(), {leaf.x, leaf.y, leaf.size});
+                 }
+                 return toArray(std::move(rows), 3);
+             },
+             "(n, 3) int32 array of free leaves as x, y, size")
+        .def("leaf_at", &QuadTree::leafAt, py::arg("x"), py::arg("y"))
+        .def("__len__", &QuadTree::leafCount);
+
+    m.def("find_path_quadtree",
+          [](const PathFinder::Grid& grid, const PathFinder::Point& start, const PathFinder::Point& end,
+             const QuadTree* tree) {
+              py::gil_scoped_release release;
+              if (tree) {
+                  return PathFinder::findPathQuadTree(grid, *tree, start, end);
+              }
+              return PathFinder::findPathQuadTree(grid, QuadTree(grid), start, end);
+          },
+          py::arg("grid"), py::arg("start"), py::arg("end"), py::arg("tree") = nullptr,
+          "Plan over free quadtree leaves and straighten with line of sight; pass a QuadTree built "
+          "from the same grid to reuse it across queries");
+
+    py::class_<TiledMap>(m, "TiledMap")
+        .def(py::init<const std::string&, size_t>(), py::arg("path"), py::arg("cache_tiles") = 256,
+             "Open a tiled map file; at most cache_tiles decoded tiles are kept between queries")
+        .def("blocked",
+             [](const TiledMap& map, int x, int y) {
+                 if (x < 0 || x >= map.rows() || y < 0 || y >= map.cols()) {
+                     throw py::index_error("Cell outside the map");
+                 }
+                 return TiledMap::View(map).blocked(x, y);
+             },
+             py::arg("x"), py::arg("y"))
+        .def_property_readonly("rows", &TiledMap::rows)
+        .def_property_readonly("cols", &TiledMap::cols)
+        .def_property_readonly("tile_size", &TiledMap::tileSize)
+        .def_property_readonly("cached_tiles", &TiledMap::cachedTiles);
+
+    py::class_<TiledMap::Writer>(m, "TiledMapWriter")
+        .def(py::init<const std::string&, int64_t, int64_t, int>(), py::arg("path"), py::arg("rows"),
+             py::arg("cols"), py::arg("tile_size") = 256)
+        .def("write_rows",
+             [](TiledMap::Writer& writer, OccupancyArray rows) {
+                 if (rows.ndim() != 2) {
+                     throw std::invalid_argument("rows must be a 2-D array");
+                 }
+                 if (rows.shape(1) != writer.cols()) {
+                     throw std::invalid_argument("rows must have " + std::to_string(writer.cols()) +
+                                                 " columns, got " + std::to_string(rows.shape(1)));
+                 }
+                 writer.writeRows(rows.data(), rows.shape(0));
+             },
+             py::arg("rows"), "Append (n, cols) occupancy rows (nonzero = blocked), top to bottom")
+        .def("close", &TiledMap::Writer::close)
+        .def("__enter__", [](TiledMap::Writer& writer) -> TiledMap::Writer& { return writer; },
+             py::return_value_policy::reference)
+        .def("__exit__",
+             [](TiledMap::Writer& writer, py::object type, py::args) {
+                 // Leave a failed write incomplete rather than masking the original error
+                 if (type.is_none()) {
+                     writer.close();
+                 }
+             })
+        .def_property_readonly("rows_written", &TiledMap::Writer::rowsWritten)
+        .def_property_readonly("rows", &TiledMap::Writer::rows)
+        .def_property_readonly("cols", &TiledMap::Writer::cols);
+
+    m.def("find_path_tiled",
+          py::overload_cast<const TiledMap&, const PathFinder::Point&, const PathFinder::Point&>(
+              &PathFinder::findPath),
+          py::arg("map"), py::arg("start"), py::arg("end"), py::call_guard<py::gil_scoped_release>(),
+          "Theta* on a TiledMap; tiles are paged in as the search reaches them");
+
+    py::class_<RollingGrid>(m, "RollingGrid")
+        .def(py::init<int, int, uint8_t>(), py::arg("rows"), py::arg("cols"), py::arg("fill") = 0,
+             "Toroidal occupancy window over an unbounded world grid; scrolled-in cells start at fill")
+        .def("move_to", &RollingGrid::moveTo, py::arg("x"), py::arg("y"),
+             "Put the window's top-left corner at world cell (x, y); returns the number of cells reset")
+        .def("recenter", &RollingGrid::recenter, py::arg("x"), py::arg("y"),
+             "Center the window on world cell (x, y); returns the number of cells reset")
+        .def("set", &RollingGrid::set, py::arg("x"), py::arg("y"), py::arg("value"))
+        .def("get", &RollingGrid::get, py::arg("x"), py::arg("y"))
+        .def("contains", &RollingGrid::contains, py::arg("x"), py::arg("y"))
+        .def("write_patch",
+             [](RollingGrid& grid, int64_t x, int64_t y, OccupancyArray patch) {
+                 if (patch.ndim() != 2) {
+                     throw std::invalid_argument("patch must be a 2-D array");
+                 }
+                 grid.writePatch(x, y, patch.data(), (int)patch.shape(0), (int)patch.shape(1));
+             },
+             py::arg("x"), py::arg("y"), py::arg("patch"),
+             "Write a 2-D patch whose top-left is world cell (x, y), clipped to the window")
+        .def("window",
+             [](const RollingGrid& grid) {
+                 py::array_t<uint8_t> out({(py::ssize_t)grid.rows(), (py::ssize_t)grid.cols()});
+                 grid.window(out.mutable_data());
+                 return out;
+             },
+             "Copy of the window in local coordinates")
+        .def("to_local",
+             [](const RollingGrid& grid, int64_t x, int64_t y) {
+                 return PathFinder::Point((int)(x - grid.originX()), (int)(y - grid.originY()));
+             },
+             py::arg("x"), py::arg("y"))
+        .def("to_world",
+             [](const RollingGrid& grid, int x, int y) {
+                 return std::make_pair(grid.originX() + x, grid.originY() + y);
+             },
+             py::arg("x"), py::arg("y"))
+        .def_property_readonly("origin",
+                               [](const RollingGrid& grid) { return std::make_pair(grid.originX(), grid.originY()); })
+        .def_property_readonly("rows", &RollingGrid::rows)
+        .def_property_readonly("cols", &RollingGrid::cols);
+
+    m.def("find_path_local",
+          py::overload_cast<const RollingGrid&, const PathFinder::Point&, const PathFinder::Point&>(
+              &PathFinder::findPath),
+          py::arg("window"), py::arg("start"), py::arg("end"), py::call_guard<py::gil_scoped_release>(),
+          "Theta* inside a RollingGrid; start, end and the result are window-local coordinates");
+
+    py::class_<HybridAStar::Params>(m, "HybridParams")
+        .def(py::init<>())
+        .def_readwrite("min_turning_radius", &HybridAStar::Params::min_turning_radius)
+        .def_readwrite("step_length", &HybridAStar::Params::step_length)
+        .def_readwrite("steering_samples", &HybridAStar::Params::steering_samples)
+        .def_readwrite("heading_bins", &HybridAStar::Params::heading_bins)
+        .def_readwrite("allow_reverse", &HybridAStar::Params::allow_reverse)
+        .def_readwrite("reverse_penalty", &HybridAStar::Params::reverse_penalty)
+        .def_readwrite("steering_penalty", &HybridAStar::Params::steering_penalty)
+        .def_readwrite("steering_change_penalty", &HybridAStar::Params::steering_change_penalty)
+        .def_readwrite("direction_change_penalty", &HybridAStar::Params::direction_change_penalty)
+        .def_readwrite("goal_tolerance", &HybridAStar::Params::goal_tolerance)
+        .def_readwrite("heading_tolerance", &HybridAStar::Params::heading_tolerance)
+        .def_readwrite("max_expansions", &HybridAStar::Params::max_expansions)
+        .def_readwrite("analytic_expansion_range", &HybridAStar::Params::analytic_expansion_range);
+
+    py::class_<DubinsTable>(m, "DubinsTable")
+        .def(py::init<float, float, float, int>(),
+             py::arg("turning_radius"), py::arg("extent"), py::arg("resolution"), py::arg("heading_bins") = 72)
+        .def_static("load", &DubinsTable::load, py::arg("path"))
+        .def("save", &DubinsTable::save, py::arg("path"))
+        .def("distance", py::overload_cast<float, float, float>(&DubinsTable::distance, py::const_),
+             py::arg("dx"), py::arg("dy"), py::arg("dheading"),
+             "Lower bound on dubins_distance from the table, within about one cell of it")
+        .def_property_readonly("turning_radius", &DubinsTable::turningRadius)
+        .def_property_readonly("extent", &DubinsTable::extent)
+        .def_property_readonly("resolution", &DubinsTable::resolution)
+        .def_property_readonly("heading_bins", &DubinsTable::headingBins);
+
+    m.def("dubins_distance", &DubinsTable::dubinsDistance,
+          py::arg("dx"), py::arg("dy"), py::arg("dheading"), py::arg("turning_radius"),
+          "Exact Dubins path length to a pose given in the start frame");
+
+    m.def("find_path_hybrid",
+        [](const PathFinder::Grid& grid, std::tuple<float, float, float> start,
+           std::tuple<float, float, float> goal, HybridAStar::Params params, const DubinsTable* dubins_table) {
+            params.dubins_table = dubins_table;
+            HybridAStar::Trajectory trajectory = HybridAStar::findPath(
+                grid,
+                {std::get<0>(start), std::get<1>(start), std::get<2>(start)},
+                {std::get<0>(goal), std::get<1>(goal), std::get<2>(goal)},
+                params);
+            std::vector<std::tuple<float, float, float>> poses;
+            poses.reserve(trajectory.size());
+            for (const auto& pose : trajectory) {
+                poses.emplace_back(pose.x, pose.y, pose.heading);
+            }
+            return poses;
+        },
+        py::arg("grid"), py::arg("start"), py::arg("goal"), py::arg("params") = HybridAStar::Params(),
+        py::arg("dubins_table") = nullptr,
+        "Hybrid A* over (x, y, heading); poses in grid cells and radians");
+
+    m.def("resample_path",
+        [](DoubleArray points, double step) {
+            requireColumns(points, 2, "points");
+            return toArray(PathProcessing::resample(points.data(), points.shape(0), step), 2);
+        },
+        py::arg("points"), py::arg("step") = 1.0,
+        "Resample an (n, 2) polyline every `step` cm of arc length");
+
+    m.def("smooth_path",
+        [](DoubleArray points, double distance, double step) {
+            requireColumns(points, 2, "points");
+            return toArray(PathProcessing::smoothPath(points.data(), points.shape(0), distance, step), 2);
+        },
+        py::arg("points"), py::arg("distance") = 50.0, py::arg("step") = 1.0,
+        "Midpoints of two walkers `distance` cm apart along an (n, 2) polyline");
+
+    m.def("compute_path_data",
+        [](DoubleArray points, py::object out) {
+            requireColumns(points, 2, "points");
+            const py::ssize_t rows = std::max<py::ssize_t>(points.shape(0) - 1, 0);
+            const py::ssize_t columns = (py::ssize_t)PathProcessing::kPathDataColumns;
+            py::array data = out.is_none() ? py::array(py::array_t<float>({rows, columns})) : out.cast<py::array>();
+            float* rows_out = writableRows<float>(data, rows, columns, "out");
+            PathProcessing::computePathData(points.data(), points.shape(0), rows_out);
+            return data;
+        },
+        py::arg("points"), py::arg("out") = py::none(),
+        "Fill (n-1, 5) float32 rows of x, y, curvature, heading, distance for an (n, 2) path");
+
+    m.def("smooth_curvature",
+        [](DoubleArray distances, DoubleArray curvatures, double window_size_cm) {
+            if (distances.ndim() != 1 || curvatures.ndim() != 1 || distances.shape(0) != curvatures.shape(0)) {
+                throw std::invalid_argument("distances and curvatures must be 1-D arrays of equal length");
+            }
+            py::array_t<double> smoothed(distances.shape(0));
+            SpeedProfile::smoothCurvature(distances.data(), curvatures.data(), distances.shape(0),
+                                          window_size_cm, smoothed.mutable_data());
+            return smoothed;
+        },
+        py::arg("distances"), py::arg("curvatures"), py::arg("window_size_cm") = 50.0,
+        "Distance-windowed Gaussian smoothing of curvature, as in calculate_speed_limits");
+
+    m.def("apply_speed_limits",
+        [](py::array path_data, double max_speed, double min_speed, double max_turning_speed_rad_s,
+           double max_accel, double max_decel, double window_size_cm, double max_jerk, py::object speed_caps) {
+            const SpeedProfile::Params params = {
+                max_speed, min_speed, max_turning_speed_rad_s, max_accel, max_decel, window_size_cm, max_jerk
+            };
+            std::vector<SpeedProfile::SpeedCap> caps;
+            if (!speed_caps.is_none()) {
+                DoubleArray cap_rows = speed_caps.cast<DoubleArray>();
+                requireColumns(cap_rows, 3, "speed_caps");
+                for (py::ssize_t i = 0; i < cap_rows.shape(0); i++) {
+                    caps.push_back({cap_rows.at(i, 0), cap_rows.at(i, 1), cap_rows.at(i, 2)});
+                }
+            }
+
+            const py::ssize_t rows = path_data.ndim() == 2 ? path_data.shape(0) : 0;
+            const py::ssize_t columns = (py::ssize_t)SpeedProfile::kSpeedColumn + 1;
+            if (path_data.dtype().is(py::dtype::of<float>())) {
+                float* data = writableRows<float>(path_data, rows, columns, "path_data");
+                py::gil_scoped_release release;
+                SpeedProfile::apply(data, rows, columns, params, caps);
+            } else {
+                double* data = writableRows<double>(path_data, rows, columns, "path_data");
+                py::gil_scoped_release release;
+                SpeedProfile::apply(data, rows, columns, params, caps);
+            }
+        },
+        py::arg("path_data"), py::arg("max_speed"), py::arg("min_speed"), py::arg("max_turning_speed_rad_s"),
+        py::arg("max_accel"), py::arg("max_decel"), py::arg("window_size_cm") = 50.0, py::arg("max_jerk") = 0.0,
+        py::arg("speed_caps") = py::none(),
+        "Fill the speed limit column of an (n, 6) float32/float64 path_data array in place. "
+        "speed_caps is an optional (m, 3) array of [start_cm, end_cm, max_speed] rows.");
+
+    py::class_<PathNavigator::NavInfo>(m, "NavInfo")
+        .def_readonly("distance_from_start", &PathNavigator::NavInfo::distance_from_start)
+        .def_readonly("heading", &PathNavigator::NavInfo::heading)
+        .def_readonly("speed_limit", &PathNavigator::NavInfo::speed_limit)
+        .def_readonly("path_offset", &PathNavigator::NavInfo::path_offset)
+        .def_readonly("is_last_point", &PathNavigator::NavInfo::is_last_point)
+        .def_readonly("segment", &PathNavigator::NavInfo::segment)
+        .def_readonly("ratio", &PathNavigator::NavInfo::ratio);
+
+    py::class_<PathNavigator::PathSample>(m, "PathSample")
+        .def_readonly("x", &PathNavigator::PathSample::x)
+        .def_readonly("y", &PathNavigator::PathSample::y)
+        .def_readonly("heading", &PathNavigator::PathSample::heading)
+        .def_readonly("curvature", &PathNavigator::PathSample::curvature)
+        .def_readonly("speed_limit", &PathNavigator::PathSample::speed_limit)
+        .def_readonly("distance", &PathNavigator::PathSample::distance);
+
+    py::class_<PathNavigator>(m, "PathNavigator")
+        .def(py::init([](DoubleArray path_data, size_t window_size, double relocalization_distance) {
+                 if (path_data.ndim() != 2) {
+                     throw std::invalid_argument("path_data must be a 2-D array");
+                 }
+                 return PathNavigator(path_data.data(), path_data.shape(0), path_data.shape(1), window_size,
+                                      relocalization_distance);
+             }),
+             py::arg("path_data"), py::arg("window_size") = 500, py::arg("relocalization_distance") = 50.0)
+        .def("update", &PathNavigator::update, py::arg("x"), py::arg("y"),
+             "Project the robot onto the path and return interpolated navigation info")
+        .def("set_path",
+             [](PathNavigator& navigator, DoubleArray path_data) {
+                 if (path_data.ndim() != 2) {
+                     throw std::invalid_argument("path_data must be a 2-D array");
+                 }
+                 navigator.setPath(path_data.data(), path_data.shape(0), path_data.shape(1));
+             },
+             py::arg("path_data"), "Switch to a new path; the next update relocalizes on it")
+        .def("relocalize", &PathNavigator::relocalize, py::arg("x"), py::arg("y"),
+             "Jump to the globally nearest path segment")
+        .def("update_batch",
+             [](PathNavigator& navigator, DoubleArray poses) {
+                 requireColumns(poses, 2, "poses");
+                 const py::ssize_t count = poses.shape(0);
+                 py::array_t<double> out({count, (py::ssize_t)PathNavigator::kBatchColumns});
+                 double* rows = out.mutable_data();
+                 // Keeps the GIL like update() and set_path(), which share the tracking state
+                 navigator.updateBatch(poses.data(), count, rows);
+                 return out;
+             },
+             py::arg("poses"),
+             "Track an (N, 2) pose sequence; returns (N, 5) rows of distance_from_start, heading, "
+             "speed_limit, path_offset, is_last_point")
+        .def("point_at", &PathNavigator::pointAt, py::arg("distance"),
+             "Interpolated path state at `distance` cm from the start (clamped to the path)")
+        .def("lookahead", &PathNavigator::lookahead, py::arg("distance"),
+             "Interpolated path state `distance` cm ahead of the last projected position")
+        .def("reset", &PathNavigator::reset)
+        .def_property_readonly("current_index", &PathNavigator::currentIndex)
+        .def("__len__", &PathNavigator::size);
+
+    py::class_<TrajectoryPublisher>(m, "TrajectoryPublisher")
+        .def(py::init<const std::string&, size_t, size_t>(), py::arg("name"), py::arg("max_rows"),
+             py::arg("columns") = 6,
+             "Create the shared-memory segment `name` (e.g. '/planner_path'), or take over the one "
+             "a previous publisher left; it outlives the publisher until remove() is called")
+        .def("publish",
+             [](TrajectoryPublisher& publisher, DoubleArray rows) {
+                 requireColumns(rows, (py::ssize_t)publisher.columns(), "rows");
+                 return publisher.publish(rows.data(), rows.shape(0));
+             },
+             py::arg("rows"), "Atomically replace the published trajectory; returns its generation")
+        .def_static("remove", &TrajectoryPublisher::remove, py::arg("name"),
+                    "Delete the segment `name`; attached subscribers see it retired")
+        .def_property_readonly("capacity", &TrajectoryPublisher::capacity)
+        .def_property_readonly("columns", &TrajectoryPublisher::columns);
+
+    py::class_<TrajectorySubscriber>(m, "TrajectorySubscriber")
+        .def(py::init<const std::string&>(), py::arg("name"))
+        .def_property_readonly("generation", &TrajectorySubscriber::generation,
+                               "Generation of the latest published trajectory (0 = none yet)")
+        .def_property_readonly("retired", &TrajectorySubscriber::retired,
+                               "True once the segment was replaced or removed; reopen it by name")
+        .def("read",
+             [](const TrajectorySubscriber& subscriber) {
+                 uint64_t generation;
+                 std::vector<double> rows;
+                 {
+                     py::gil_scoped_release release;
+                     rows = subscriber.read(generation);
+                 }
+                 return py::make_tuple(toArray(std::move(rows), subscriber.columns()), generation);
+             },
+             "Consistent copy of the latest trajectory as (rows, generation)")
+        .def_property_readonly("columns", &TrajectorySubscriber::columns);
+
+    py::class_<PathFile::Writer>(m, "PathFileWriter")
+        .def(py::init([](const std::string& filename, size_t columns, const std::string& dtype, bool append) {
+                 return new PathFile::Writer(filename, parseDType(dtype), columns, append);
+             }),
+             py::arg("filename"), py::arg("columns"), py::arg("dtype") = "float32", py::arg("append") = false,
+             "Streaming writer for binary waypoint files; append=True continues an existing file")
+        .def("append", &appendRows, py::arg("rows"), "Append an (n, columns) array of rows")
+        .def("flush", &PathFile::Writer::flush, "Write buffered rows and update the header row count")
+        .def("close", &PathFile::Writer::close)
+        .def("__enter__", [](PathFile::Writer& writer) -> PathFile::Writer& { return writer; },
+             py::return_value_policy::reference)
+        .def("__exit__", [](PathFile::Writer& writer, py::args) { writer.close(); })
+        .def_property_readonly("rows", &PathFile::Writer::rows)
+        .def_property_readonly("columns", &PathFile::Writer::columns);
+
+    m.def("write_path_file",
+          [](const std::string& filename, const py::array& rows) {
+              if (rows.ndim() != 2) {
+                  throw std::invalid_argument("rows must be a 2-D array");
+              }
+              const char kind = rows.dtype().kind();
+              const PathFile::DType dtype = (kind == 'i' || kind == 'u' || kind == 'b') ? PathFile::Int32
+                                                                                       : PathFile::Float32;
+              PathFile::Writer writer(filename, dtype, rows.shape(1));
+              appendRows(writer, rows);
+              writer.close();
+          },
+          py::arg("filename"), py::arg("rows"),
+          "Write an (n, columns) array as a binary waypoint file: integer arrays as int32, others as float32");
+
+    m.def("read_path_file",
+          [](const std::string& filename) {
+              std::unique_ptr<PathFile::Reader> owned(new PathFile::Reader(filename));
+              PathFile::Reader* reader = owned.get();
+              py::capsule unmap_when_done(reader, [](void* p) { delete reinterpret_cast<PathFile::Reader*>(p); });
+              owned.release();  // the capsule deletes it from here on
+              const py::dtype dtype = reader->dtype() == PathFile::Int32 ? py::dtype::of<int32_t>()
+                                                                         : py::dtype::of<float>();
+              const py::ssize_t columns = (py::ssize_t)reader->columns();
+              py::array rows(dtype, std::vector<py::ssize_t>{(py::ssize_t)reader->rows(), columns},
+                             std::vector<py::ssize_t>{columns * 4, 4}, reader->data(), unmap_when_done);
+              rows.attr("setflags")(py::arg("write") = false);
+              return rows;
+          },
+          py::arg("filename"), "Memory-map a binary waypoint file as a read-only (n, columns) array");
+
+    py::class_<DynamicEDT>(m, "DynamicEDT")
+        .def(py::init<int, int>(), py::arg("rows"), py::arg("cols"))
+        .def(py::init([](OccupancyArray occupancy) {
+                 if (occupancy.ndim() != 2) {
+                     throw std::invalid_argument("occupancy must be a 2-D array");
+                 }
+                 return new DynamicEDT(occupancy.data(), (int)occupancy.shape(0), (int)occupancy.shape(1));
+             }),
+             py::arg("occupancy"), "Distance map of a 2-D occupancy array (nonzero = obstacle)")
+        .def("set_obstacle", &DynamicEDT::setObstacle, py::arg("x"), py::arg("y"))
+        .def("remove_obstacle", &DynamicEDT::removeObstacle, py::arg("x"), py::arg("y"))
+        .def("set_occupancy",
+             [](DynamicEDT& edt, OccupancyArray occupancy) {
+                 requireShape(occupancy, edt.rows(), edt.cols(), "occupancy");
+                 edt.setOccupancy(occupancy.data());
+             },
+             py::arg("occupancy"), "Queue the cells that differ from a new occupancy snapshot")
+        .def("update", &DynamicEDT::update, py::call_guard<py::gil_scoped_release>(),
+             "Propagate queued changes; returns the number of cells processed")
+        .def("is_occupied", py::overload_cast<int, int>(&DynamicEDT::isOccupied, py::const_), py::arg("x"),
+             py::arg("y"))
+        .def("distance", &DynamicEDT::distance, py::arg("x"), py::arg("y"))
+        .def("distances",
+             [](const DynamicEDT& edt) {
+                 py::array_t<float> out({(py::ssize_t)edt.rows(), (py::ssize_t)edt.cols()});
+                 edt.distances(out.mutable_data());
+                 return out;
+             },
+             "(rows, cols) float32 distances to the nearest obstacle in cells")
+        .def_property_readonly("rows", &DynamicEDT::rows)
+        .def_property_readonly("cols", &DynamicEDT::cols);
+
+    m.def("inflate_costmap",
+          [](OccupancyArray occupancy, float inscribed_radius, float inflation_radius, float cost_scaling_factor,
+             const std::vector<std::pair<float, int>>& bands, uint8_t occupied_threshold, py::object out) {
+              if (occupancy.ndim() != 2) {
+                  throw std::invalid_argument("occupancy must be a 2-D array");
+              }
+              Costmap::Params params;
+              params.inscribed_radius = inscribed_radius;
+              params.inflation_radius = inflation_radius;
+              params.cost_scaling_factor = cost_scaling_factor;
+              params.occupied_threshold = occupied_threshold;
+              for (const auto& band : bands) {
+                  if (band.second < 0 || band.second > 255) {
+                      throw std::invalid_argument("Band costs must be in [0, 255]");
+                  }
+                  params.bands.push_back({band.first, (uint8_t)band.second});
+              }
+
+              const py::ssize_t rows = occupancy.shape(0);
+              const py::ssize_t cols = occupancy.shape(1);
+              py::array result = out.is_none() ? py::array_t<uint8_t>({rows, cols}) : out.cast<py::array>();
+              uint8_t* data = writableRows<uint8_t>(result, rows, cols, "out");
+              const uint8_t* input = occupancy.data();
+              {
+                  py::gil_scoped_release release;
+                  Costmap::inflate(input, (int)rows, (int)cols, params, data);
+              }
+              return result;
+          },
+          py::arg("occupancy"), py::arg("inscribed_radius"), py::arg("inflation_radius"),
+          py::arg("cost_scaling_factor") = 10.0f, py::arg("bands") = std::vector<std::pair<float, int>>(),
+          py::arg("occupied_threshold") = 1, py::arg("out") = py::none(),
+          "uint8 costmap of an occupancy grid (cells >= occupied_threshold are obstacles): 254 lethal, "
+          "253 inscribed, exponential decay out to inflation_radius, plus fixed (radius, cost) bands. "
+          "Pass out=occupancy to inflate a uint8 grid in place.");
+}
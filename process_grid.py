@@ -1,6 +1,7 @@
 import cv2
 import numpy as np
 from scipy.ndimage import distance_transform_edt
+import pathfinder  # Our C++ module
 
 def create_cost_map(input_path, output_path, buffer_distance=5, buffer_color=(127, 127, 127)):
     # Read the input image
@@ -28,6 +29,54 @@ def create_cost_map(input_path, output_path, buffer_distance=5, buffer_color=(12
     cv2.imwrite(output_path, output)
     print(f"Cost map saved to {output_path}")
 
+def create_layered_cost_map(input_path, output_path, inscribed_radius=5, inflation_radius=15,
+                            cost_scaling_factor=0.3, bands=()):
+    """Grayscale cost map with graded inflation instead of a single hard buffer.
+    
+    Obstacles are 254, cells within inscribed_radius 253, and cost decays exponentially out
+    to inflation_radius. bands adds fixed (radius, cost) levels. Radii are in cells.
+    
+    The returned array holds these costs. The image is saved as 255 - cost to match the
+    occupancy images (white free, black blocked), so astar.image_to_grid treats cells costing
+    more than 255 - threshold as obstacles.
+    """
+    img = cv2.imread(input_path, cv2.IMREAD_GRAYSCALE)
+    if img is None:
+        raise FileNotFoundError(f"Could not read image at {input_path}")
+    
+    # Same occupancy rule as create_cost_map: pixels <= 1 are obstacles. The mask is
+    # reused as the output buffer, so inflation runs in place.
+    costs = (img <= 1).astype(np.uint8)
+    pathfinder.inflate_costmap(costs, inscribed_radius, inflation_radius, cost_scaling_factor,
+                               list(bands), out=costs)
+    
+    cv2.imwrite(output_path, 255 - costs)
+    print(f"Layered cost map saved to {output_path}")
+    return costs
+
+class IncrementalCostMap:
+    """Cost map kept up to date from successive occupancy snapshots.
+    
+    The distance transform is maintained natively and only recomputed around cells whose
+    occupancy changed, so updates at sensor rate stay cheap.
+    """
+    def __init__(self, occupancy, buffer_distance=5):
+        self.buffer_distance = buffer_distance
+        self._edt = pathfinder.DynamicEDT(np.asarray(occupancy, dtype=np.uint8))
+    
+    def update(self, occupancy):
+        """Apply a new occupancy snapshot (nonzero = occupied); returns cells reprocessed."""
+        self._edt.set_occupancy(np.asarray(occupancy, dtype=np.uint8))
+        return self._edt.update()
+    
+    def distances(self):
+        """Distance from every cell to the nearest occupied cell, in cells."""
+        return self._edt.distances()
+    
+    def buffer_mask(self):
+        """Cells within buffer_distance of an occupied cell (same rule as create_cost_map)."""
+        return self.distances() <= self.buffer_distance
+
 if __name__ == "__main__":
     input_image = "ocupancy.png"
     output_image = "cost_map.png"
@@ -0,0 +1,77 @@
+#include "quadtree.h"
+#include <algorithm>
+
+QuadTree::QuadTree(const PathFinder::Grid& grid)
+    : rows_((int)grid.size()), cols_(grid.empty() ? 0 : (int)grid[0].size()),
+      leaf_of_((size_t)rows_ * cols_, -1) {
+    // Summed-area table of blocked cells, so each block is classified in O(1)
+    const int stride = cols_ + 1;
+    std::vector<int> blocked((size_t)(rows_ + 1) * stride, 0);
+    for (int x = 0; x < rows_; x++) {
+        int row_sum = 0;
+        for (int y = 0; y < cols_; y++) {
+            row_sum += grid[x][y] != 0;
+            blocked[(size_t)(x + 1) * stride + y + 1] = blocked[(size_t)x * stride + y + 1] + row_sum;
+        }
+    }
+
+    int size = 1;
+    while (size < rows_ || size < cols_) {
+        size *= 2;
+    }
+    if (rows_ > 0 && cols_ > 0) {
+        subdivide(blocked, 0, 0, size);
+    }
+    linkNeighbours();
+}
+
+void QuadTree::subdivide(const std::vector<int>& blocked, int x, int y, int size) {
+    // Only the part of the block inside the grid matters; the rest counts as blocked
+    const int x_end = std::min(x + size, rows_);
+    const int y_end = std::min(y + size, cols_);
+    if (x >= x_end || y >= y_end) {
+        return;
+    }
+    const int stride = cols_ + 1;
+    const int count = blocked[(size_t)x_end * stride + y_end] - blocked[(size_t)x * stride + y_end] -
+                      blocked[(size_t)x_end * stride + y] + blocked[(size_t)x * stride + y];
+    const int area = (x_end - x) * (y_end - y);
+    if (count == area) {
+        return;
+    }
+    if (count == 0 && x + size <= rows_ && y + size <= cols_) {
+        const int id = (int)leaves_.size();
+        leaves_.push_back({x, y, size});
+        for (int i = x; i < x_end; i++) {
+            std::fill(leaf_of_.begin() + (size_t)i * cols_ + y, leaf_of_.begin() + (size_t)i * cols_ + y_end, id);
+        }
+        return;
+    }
+    const int half = size / 2;
+    subdivide(blocked, x, y, half);
+    subdivide(blocked, x, y + half, half);
+    subdivide(blocked, x + half, y, half);
+    subdivide(blocked, x + half, y + half, half);
+}
+
+void QuadTree::linkNeighbours() {
+    neighbour_start_.assign(leaves_.size() + 1, 0);
+    std::vector<int> found;
+    for (size_t i = 0; i < leaves_.size(); i++) {
+        const Leaf& leaf = leaves_[i];
+        found.clear();
+        // Walk the ring of cells just outside each edge
+        for (int k = 0; k < leaf.size; k++) {
+            for (int id : {leafAt(leaf.x - 1, leaf.y + k), leafAt(leaf.x + leaf.size, leaf.y + k),
+                           leafAt(leaf.x + k, leaf.y - 1), leafAt(leaf.x + k, leaf.y + leaf.size)}) {
+                if (id >= 0) {
+                    found.push_back(id);
+                }
+            }
+        }
+        std::sort(found.begin(), found.end());
+        found.erase(std::unique(found.begin(), found.end()), found.end());
+        neighbours_.insert(neighbours_.end(), found.begin(), found.end());
+        neighbour_start_[i + 1] = neighbours_.size();
+    }
+}
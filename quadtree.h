@@ -0,0 +1,46 @@
+#ifndef QUADTREE_H
+#define QUADTREE_H
+
+#include <vector>
+#include <cstddef>
+#include "pathfinder.h"
+
+// Free space of an occupancy grid as the leaves of a region quadtree: square blocks that
+// are entirely free, split down to single cells only along obstacle boundaries. Open
+// terrain collapses into a few large leaves, which the planner searches instead of cells.
+class QuadTree {
+public:
+    explicit QuadTree(const PathFinder::Grid& grid);
+
+    struct Leaf {
+        int x, y;  // first row and column
+        int size;  // side length in cells
+    };
+
+    size_t leafCount() const { return leaves_.size(); }
+    const Leaf& leaf(size_t i) const { return leaves_[i]; }
+
+    // Free leaf covering a cell, -1 for blocked or out-of-range cells
+    int leafAt(int x, int y) const {
+        return x < 0 || x >= rows_ || y < 0 || y >= cols_ ? -1 : leaf_of_[(size_t)x * cols_ + y];
+    }
+
+    // Free leaves sharing an edge with leaf `i`
+    const int* neighboursBegin(size_t i) const { return neighbours_.data() + neighbour_start_[i]; }
+    const int* neighboursEnd(size_t i) const { return neighbours_.data() + neighbour_start_[i + 1]; }
+
+    int rows() const { return rows_; }
+    int cols() const { return cols_; }
+
+private:
+    void subdivide(const std::vector<int>& blocked, int x, int y, int size);
+    void linkNeighbours();
+
+    int rows_, cols_;
+    std::vector<Leaf> leaves_;
+    std::vector<int> leaf_of_;            // row-major leaf index per cell
+    std::vector<size_t> neighbour_start_; // CSR offsets into neighbours_, size leaves + 1
+    std::vector<int> neighbours_;
+};
+
+#endif // QUADTREE_H
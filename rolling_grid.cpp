@@ -0,0 +1,80 @@
+#include "rolling_grid.h"
+#include <algorithm>
+#include <cstdlib>
+#include <stdexcept>
+
+RollingGrid::RollingGrid(int rows, int cols, uint8_t fill)
+    : rows_(rows), cols_(cols), fill_(fill), origin_x_(0), origin_y_(0), offset_x_(0), offset_y_(0),
+      cells_((size_t)std::max(rows, 0) * std::max(cols, 0), fill) {
+    if (rows <= 0 || cols <= 0) {
+        throw std::invalid_argument("Rolling grid dimensions must be positive");
+    }
+}
+
+size_t RollingGrid::moveTo(int64_t x, int64_t y) {
+    const int64_t dx = x - origin_x_;
+    const int64_t dy = y - origin_y_;
+    size_t reset = 0;
+
+    if (std::llabs(dx) >= rows_ || std::llabs(dy) >= cols_) {
+        // Nothing of the old window survives
+        std::fill(cells_.begin(), cells_.end(), fill_);
+        reset = cells_.size();
+    } else {
+        // World rows entering the window, then world columns; a corner may be reset twice
+        const int64_t row_first = dx > 0 ? origin_x_ + rows_ : x;
+        for (int64_t wx = row_first; wx < row_first + std::llabs(dx); wx++) {
+            const size_t start = (size_t)wrap(wx, rows_) * cols_;
+            std::fill(cells_.begin() + start, cells_.begin() + start + cols_, fill_);
+        }
+        const int64_t col_first = dy > 0 ? origin_y_ + cols_ : y;
+        for (int64_t wy = col_first; wy < col_first + std::llabs(dy); wy++) {
+            const int j = wrap(wy, cols_);
+            for (int i = 0; i < rows_; i++) {
+                cells_[(size_t)i * cols_ + j] = fill_;
+            }
+        }
+        reset = (size_t)std::llabs(dx) * cols_ + (size_t)std::llabs(dy) * rows_;
+    }
+
+    origin_x_ = x;
+    origin_y_ = y;
+    offset_x_ = wrap(x, rows_);
+    offset_y_ = wrap(y, cols_);
+    return reset;
+}
+
+void RollingGrid::set(int64_t x, int64_t y, uint8_t value) {
+    if (contains(x, y)) {
+        cells_[(size_t)wrap(x, rows_) * cols_ + wrap(y, cols_)] = value;
+    }
+}
+
+uint8_t RollingGrid::get(int64_t x, int64_t y) const {
+    return contains(x, y) ? cells_[(size_t)wrap(x, rows_) * cols_ + wrap(y, cols_)] : fill_;
+}
+
+void RollingGrid::writePatch(int64_t x, int64_t y, const uint8_t* patch, int height, int width) {
+    const int64_t x_begin = std::max(x, origin_x_);
+    const int64_t x_end = std::min(x + height, origin_x_ + rows_);
+    const int64_t y_begin = std::max(y, origin_y_);
+    const int64_t y_end = std::min(y + width, origin_y_ + cols_);
+    for (int64_t wx = x_begin; wx < x_end; wx++) {
+        const uint8_t* in = patch + (size_t)(wx - x) * width;
+        const int lx = (int)(wx - origin_x_);
+        for (int64_t wy = y_begin; wy < y_end; wy++) {
+            cells_[ring(lx, (int)(wy - origin_y_))] = in[wy - y];
+        }
+    }
+}
+
+void RollingGrid::window(uint8_t* out) const {
+    // Each local row is at most two contiguous runs of storage
+    const int split = cols_ - offset_y_;
+    for (int x = 0; x < rows_; x++) {
+        const uint8_t* row = cells_.data() + ring(x, 0) - offset_y_;
+        uint8_t* dst = out + (size_t)x * cols_;
+        std::copy(row + offset_y_, row + cols_, dst);
+        std::copy(row, row + offset_y_, dst + split);
+    }
+}
@@ -0,0 +1,68 @@
+#ifndef ROLLING_GRID_H
+#define ROLLING_GRID_H
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+// Fixed-size occupancy window over an unbounded world grid, stored as a torus: world cell
+// (wx, wy) always lives at (wx mod rows, wy mod cols), so moving the window only resets the
+// cells that scroll in and never copies the rest. Local coordinates (0..rows-1, 0..cols-1)
+// are relative to the window origin, the world cell at its top-left corner.
+class RollingGrid {
+public:
+    // Cells scrolling into the window start at `fill` (nonzero = blocked)
+    RollingGrid(int rows, int cols, uint8_t fill = 0);
+
+    // Moves the window so its top-left corner is world cell (x, y); returns the number of
+    // cells reset, which is O(cells scrolled in) rather than O(window)
+    size_t moveTo(int64_t x, int64_t y);
+
+    // moveTo() with world cell (x, y) at the centre of the window
+    size_t recenter(int64_t x, int64_t y) { return moveTo(x - rows_ / 2, y - cols_ / 2); }
+
+    int64_t originX() const { return origin_x_; }
+    int64_t originY() const { return origin_y_; }
+    int rows() const { return rows_; }
+    int cols() const { return cols_; }
+
+    bool contains(int64_t x, int64_t y) const {
+        return x >= origin_x_ && x < origin_x_ + rows_ && y >= origin_y_ && y < origin_y_ + cols_;
+    }
+
+    // World-coordinate access; cells outside the window are ignored on write and read as fill
+    void set(int64_t x, int64_t y, uint8_t value);
+    uint8_t get(int64_t x, int64_t y) const;
+
+    // Writes a row-major `height` x `width` patch whose top-left is world cell (x, y),
+    // clipped to the window
+    void writePatch(int64_t x, int64_t y, const uint8_t* patch, int height, int width);
+
+    // Local-coordinate access, the map interface the planner searches
+    bool blocked(int x, int y) const { return cells_[ring(x, y)] != 0; }
+
+    // Row-major copy of the window in local coordinates
+    void window(uint8_t* out) const;
+
+private:
+    // Storage index of local cell (x, y): the origin's slot plus the offset, wrapped once
+    size_t ring(int x, int y) const {
+        int i = offset_x_ + x;
+        int j = offset_y_ + y;
+        i -= i >= rows_ ? rows_ : 0;
+        j -= j >= cols_ ? cols_ : 0;
+        return (size_t)i * cols_ + j;
+    }
+    static int wrap(int64_t value, int size) {
+        const int64_t r = value % size;
+        return (int)(r < 0 ? r + size : r);
+    }
+
+    int rows_, cols_;
+    uint8_t fill_;
+    int64_t origin_x_, origin_y_;
+    int offset_x_, offset_y_;  // storage slot of the origin
+    std::vector<uint8_t> cells_;
+};
+
+#endif // ROLLING_GRID_H
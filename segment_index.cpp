@@ -0,0 +1,128 @@
+#include "segment_index.h"
+#include <cmath>
+#include <algorithm>
+#include <limits>
+
+SegmentIndex::SegmentIndex(const double* xy, size_t count, size_t stride, double cell_size) {
+    x_.resize(count);
+    y_.resize(count);
+    for (size_t i = 0; i < count; i++) {
+        x_[i] = xy[i * stride];
+        y_[i] = xy[i * stride + 1];
+    }
+    if (count == 0) {
+        return;
+    }
+
+    const auto [min_x, max_x] = std::minmax_element(x_.begin(), x_.end());
+    const auto [min_y, max_y] = std::minmax_element(y_.begin(), y_.end());
+    min_x_ = *min_x;
+    min_y_ = *min_y;
+    const double width = *max_x - min_x_;
+    const double height = *max_y - min_y_;
+    const size_t segments = count > 1 ? count - 1 : 1;
+
+    if (cell_size <= 0) {
+        // Several segments per cell along the path, but never more cells than segments
+        double length = 0.0;
+        for (size_t i = 1; i < count; i++) {
+            length += std::hypot(x_[i] - x_[i - 1], y_[i] - y_[i - 1]);
+        }
+        cell_size = std::max(8.0 * length / segments, std::sqrt(width * height / segments));
+    }
+    cell_size_ = std::max(cell_size, 1e-3);
+    cells_x_ = (int)(width / cell_size_) + 1;
+    cells_y_ = (int)(height / cell_size_) + 1;
+
+    // Counting pass, then fill: every cell touched by a segment's bounding box
+    const size_t cells = (size_t)cells_x_ * cells_y_;
+    cell_start_.assign(cells + 1, 0);
+    auto forEachCell = [&](size_t segment, auto&& visit) {
+        const size_t next = std::min(segment + 1, count - 1);
+        int x0, y0, x1, y1;
+        cellOf(std::min(x_[segment], x_[next]), std::min(y_[segment], y_[next]), x0, y0);
+        cellOf(std::max(x_[segment], x_[next]), std::max(y_[segment], y_[next]), x1, y1);
+        for (int cy = y0; cy <= y1; cy++) {
+            for (int cx = x0; cx <= x1; cx++) {
+                visit((size_t)cy * cells_x_ + cx);
+            }
+        }
+    };
+    for (size_t s = 0; s < segments; s++) {
+        forEachCell(s, [&](size_t cell) { cell_start_[cell + 1]++; });
+    }
+    for (size_t c = 0; c < cells; c++) {
+        cell_start_[c + 1] += cell_start_[c];
+    }
+    cell_entries_.resize(cell_start_[cells]);
+    std::vector<size_t> fill(cell_start_.begin(), cell_start_.end() - 1);
+    for (size_t s = 0; s < segments; s++) {
+        forEachCell(s, [&](size_t cell) { cell_entries_[fill[cell]++] = s; });
+    }
+}
+
+void SegmentIndex::cellOf(double x, double y, int& cx, int& cy) const {
+    cx = std::min(std::max((int)std::floor((x - min_x_) / cell_size_), 0), cells_x_ - 1);
+    cy = std::min(std::max((int)std::floor((y - min_y_) / cell_size_), 0), cells_y_ - 1);
+}
+
+double SegmentIndex::project(size_t segment, double x, double y, double& ratio) const {
+    const size_t next = std::min(segment + 1, x_.size() - 1);
+    const double sx = x_[next] - x_[segment];
+    const double sy = y_[next] - y_[segment];
+    const double length_sq = sx * sx + sy * sy;
+    ratio = length_sq > 0 ? ((x - x_[segment]) * sx + (y - y_[segment]) * sy) / length_sq : 0.0;
+    ratio = std::min(std::max(ratio, 0.0), 1.0);
+    const double dx = x - (x_[segment] + sx * ratio);
+    const double dy = y - (y_[segment] + sy * ratio);
+    return dx * dx + dy * dy;
+}
+
+SegmentIndex::Match SegmentIndex::nearest(double x, double y) const {
+    Match best = {0, 0.0, std::numeric_limits<double>::infinity()};
+    if (cell_entries_.empty()) {
+        if (!x_.empty()) {
+            best.distance_sq = project(0, x, y, best.ratio);
+        }
+        return best;
+    }
+
+    int cx, cy;
+    cellOf(x, y, cx, cy);
+    const int max_ring = std::max(std::max(cx, cells_x_ - 1 - cx), std::max(cy, cells_y_ - 1 - cy));
+
+    auto visitCell = [&](int gx, int gy) {
+        if (gx < 0 || gx >= cells_x_ || gy < 0 || gy >= cells_y_) {
+            return;
+        }
+        const size_t cell = (size_t)gy * cells_x_ + gx;
+        for (size_t e = cell_start_[cell]; e < cell_start_[cell + 1]; e++) {
+            double ratio;
+            const double d = project(cell_entries_[e], x, y, ratio);
+            if (d < best.distance_sq) {
+                best = {cell_entries_[e], ratio, d};
+            }
+        }
+    };
+
+    for (int ring = 0; ring <= max_ring; ring++) {
+        if (ring == 0) {
+            visitCell(cx, cy);
+        } else {
+            for (int k = -ring; k <= ring; k++) {
+                visitCell(cx + k, cy - ring);
+                visitCell(cx + k, cy + ring);
+            }
+            for (int k = -ring + 1; k <= ring - 1; k++) {
+                visitCell(cx - ring, cy + k);
+                visitCell(cx + ring, cy + k);
+            }
+        }
+        // Anything outside this ring is at least ring * cell_size away
+        const double reach = ring * cell_size_;
+        if (best.distance_sq <= reach * reach) {
+            break;
+        }
+    }
+    return best;
+}
@@ -0,0 +1,39 @@
+#ifndef SEGMENT_INDEX_H
+#define SEGMENT_INDEX_H
+
+#include <vector>
+#include <cstddef>
+
+// Uniform grid hash over the segments of a polyline for global nearest-segment queries.
+// Each segment is listed in every cell its bounding box touches; a query searches rings of
+// cells around the query point until no closer segment can exist.
+class SegmentIndex {
+public:
+    // `xy` holds `count` row-major points with `stride` values per row. A `cell_size` of 0
+    // picks one from the mean segment length and the path's bounding box.
+    SegmentIndex(const double* xy, size_t count, size_t stride, double cell_size = 0.0);
+
+    struct Match {
+        size_t segment;     // index of the segment's first point
+        double ratio;       // projection parameter along the segment in [0, 1]
+        double distance_sq;
+    };
+
+    // Nearest segment to (x, y); `segment` is 0 with infinite distance for an empty index
+    Match nearest(double x, double y) const;
+
+    double cellSize() const { return cell_size_; }
+
+private:
+    double project(size_t segment, double x, double y, double& ratio) const;
+    void cellOf(double x, double y, int& cx, int& cy) const;
+
+    std::vector<double> x_, y_;
+    double cell_size_ = 1.0;
+    double min_x_ = 0, min_y_ = 0;
+    int cells_x_ = 0, cells_y_ = 0;
+    std::vector<size_t> cell_start_;    // CSR offsets into cell_entries_, size cells + 1
+    std::vector<size_t> cell_entries_;  // segment indices per cell
+};
+
+#endif // SEGMENT_INDEX_H
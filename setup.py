@@ -1,10 +1,31 @@
+import sys
 from setuptools import setup, Extension
 import pybind11
 
 pathfinder_module = Extension(
     'pathfinder',
-    sources=['pathfinder.cpp', 'pathfinder_bindings.cpp'],
+    sources=[
+        'pathfinder.cpp',
+        'hybrid_astar.cpp',
+        'dubins_table.cpp',
+        'path_processing.cpp',
+        'speed_profile.cpp',
+        'navigator.cpp',
+        'segment_index.cpp',
+        'trajectory_channel.cpp',
+        'path_file.cpp',
+        'dynamic_edt.cpp',
+        'costmap.cpp',
+        'grid_pyramid.cpp',
+        'quadtree.cpp',
+        'tiled_map.cpp',
+        'rolling_grid.cpp',
+        'work_stealing_pool.cpp',
+        'async_planner.cpp',
+        'pathfinder_bindings.cpp',
+    ],
     include_dirs=[pybind11.get_include()],
+    libraries=['rt'] if sys.platform.startswith('linux') else [],  # shm_open on older glibc
     language='c++',
     extra_compile_args=['-std=c++17', '-O3'],  # Enable optimizations
 )
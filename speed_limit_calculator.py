@@ -1,8 +1,9 @@
 import numpy as np
 import matplotlib.pyplot as plt
+import pathfinder  # Our C++ module
 
 def calculate_speed_limits(path_data, max_speed, min_speed, max_turning_speed_rad_s,
-                          max_accel, max_decel, window_size_cm=50):
+                          max_accel, max_decel, window_size_cm=50, max_jerk=0, speed_caps=None):
     """
     Calculate speed limits for each point in path data considering curvature, acceleration and deceleration.
     
@@ -13,54 +14,24 @@ def calculate_speed_limits(path_data, max_speed, min_speed, max_turning_speed_ra
         max_turning_speed_rad_s: maximum angular speed (radians/second)
         max_accel: maximum acceleration (cm/s²)
         max_decel: maximum deceleration (cm/s²) (positive value)
-        window_size_cm: size of moving average window in cm (default: 50)
+        window_size_cm: size of moving average window in cm, non-negative (default: 50)
+        max_jerk: maximum jerk (cm/s³) used to ramp acceleration and deceleration, 0 disables (default: 0)
+        speed_caps: optional list of (start_cm, end_cm, max_speed) zones along the path
         
     Returns:
         numpy array with added speed limit column (shape n,6)
     """
-    # Extract distances and curvature values
-    distances = path_data[:, 4]
-    curvatures = path_data[:, 2]
+    # Add an empty speed limit column; the C++ engine fills it in place:
+    # curvature smoothing -> v = ω/κ clipped to [min, max] -> caps -> accel/decel passes
+    path_data_with_speeds = np.zeros((len(path_data), 6))
+    path_data_with_speeds[:, :5] = path_data[:, :5]
     
-    # Smooth curvature with weighted moving average based on distance window
-    smoothed_curvatures = np.zeros_like(curvatures)
-    for i in range(len(curvatures)):
-        # Calculate weights using Gaussian-like distribution
-        dist_from_center = np.abs(distances - distances[i])
-        weights = np.exp(-(dist_from_center**2)/(2*(window_size_cm/4)**2))
-        weights[dist_from_center > window_size_cm/2] = 0  # Zero weights outside window
-        
-        # Normalize weights and calculate weighted average
-        normalized_weights = weights / np.sum(weights)
-        smoothed_curvatures[i] = np.sum(curvatures * normalized_weights)
-    
-    # Convert smoothed curvature to radians/cm
-    curvatures_rad_cm = np.radians(smoothed_curvatures)
-    
-    # Calculate speed limit: v = ω/κ (where ω is max angular speed in rad/s, κ is curvature in rad/cm)
-    # This gives v in cm/s
-    speed_limits = max_turning_speed_rad_s / (np.abs(curvatures_rad_cm) + 1e-6)  # Avoid division by zero
-    
-    # Clip speeds between min and max
-    speed_limits = np.clip(speed_limits, min_speed, max_speed)
-    
-    # Apply acceleration constraints (forward pass)
-    distances = path_data[:, 4]
-    speed_limits[0] = min_speed  # Start at min speed
-    
-    for i in range(1, len(speed_limits)):
-        max_speed_from_accel = np.sqrt(speed_limits[i-1]**2 + 2 * max_accel * (distances[i] - distances[i-1]))
-        speed_limits[i] = min(speed_limits[i], max_speed_from_accel)
-    
-    # Apply deceleration constraints (backward pass)
-    speed_limits[-1] = min_speed  # End at min speed
-    
-    for i in range(len(speed_limits)-2, -1, -1):
-        max_speed_from_decel = np.sqrt(speed_limits[i+1]**2 + 2 * max_decel * (distances[i+1] - distances[i]))
-        speed_limits[i] = min(speed_limits[i], max_speed_from_decel)
+    if speed_caps is not None:
+        speed_caps = np.asarray(speed_caps, dtype=np.float64).reshape(-1, 3)
     
-    # Add speed limit as new column
-    return np.column_stack((path_data, speed_limits))
+    pathfinder.apply_speed_limits(path_data_with_speeds, max_speed, min_speed, max_turning_speed_rad_s,
+                                  max_accel, max_decel, window_size_cm, max_jerk, speed_caps)
+    return path_data_with_speeds
 
 def plot_speed_profile(path_data_with_speeds, filename="speed_profile.png"):
     """Plot speed limit vs distance and save to file"""
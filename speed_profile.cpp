@@ -0,0 +1,119 @@
+#include "speed_profile.h"
+#include <cmath>
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
+void SpeedProfile::smoothCurvature(const double* distance, const double* curvature, size_t count,
+                                   double window_cm, double* out) {
+    if (!(window_cm >= 0)) {
+        throw std::invalid_argument("Curvature window must be non-negative");
+    }
+    const double half_window = window_cm / 2;
+    const double sigma = window_cm / 4;
+
+    // Gaussian sampled over [0, half_window] and linearly interpolated; the interpolation
+    // error stays below 1e-7 of the peak weight and avoids an exp() per pair of points
+    const size_t kTableSize = 4096;
+    std::vector<double> gaussian(kTableSize + 2, 1.0);
+    const double table_scale = half_window > 0 ? kTableSize / half_window : 0.0;
+    if (sigma > 0) {
+        for (size_t k = 0; k < gaussian.size(); k++) {
+            const double offset = k / table_scale;
+            gaussian[k] = std::exp(-offset * offset / (2 * sigma * sigma));
+        }
+    }
+
+    // [first, last) is the set of points within half_window of point i; both ends only move forward
+    size_t first = 0;
+    size_t last = 0;
+    for (size_t i = 0; i < count; i++) {
+        while (distance[i] - distance[first] > half_window) {
+            first++;
+        }
+        while (last < count && distance[last] - distance[i] <= half_window) {
+            last++;
+        }
+
+        double weighted = 0.0;
+        double total = 0.0;
+        for (size_t j = first; j < last; j++) {
+            const double position = std::fabs(distance[j] - distance[i]) * table_scale;
+            const size_t k = std::min((size_t)position, kTableSize);
+            const double weight = gaussian[k] + (gaussian[k + 1] - gaussian[k]) * (position - k);
+            weighted += curvature[j] * weight;
+            total += weight;
+        }
+        out[i] = weighted / total;
+    }
+}
+
+void SpeedProfile::limitSpeeds(const double* distance, size_t count, const Params& params,
+                               const std::vector<SpeedCap>& caps, double* speed) {
+    // `speed` holds the smoothed curvature (degrees/cm) on entry: v = omega / kappa
+    const double kRadians = 3.14159265358979323846 / 180.0;
+    for (size_t i = 0; i < count; i++) {
+        const double limit = params.max_turning_speed_rad_s / (std::fabs(speed[i] * kRadians) + 1e-6);
+        speed[i] = std::min(std::max(limit, params.min_speed), params.max_speed);
+    }
+
+    for (const auto& cap : caps) {
+        const double* first = std::lower_bound(distance, distance + count, cap.start_cm);
+        const double* last = std::upper_bound(distance, distance + count, cap.end_cm);
+        for (const double* it = first; it < last; it++) {
+            double& value = speed[it - distance];
+            value = std::min(value, cap.speed);
+        }
+    }
+}
+
+void SpeedProfile::accelerationPass(const double* distance, size_t count, double max_accel, double max_jerk,
+                                    bool backward, double* speed) {
+    // v_i^2 = v_prev^2 + 2 a ds. With a jerk limit the usable acceleration ramps up by
+    // max_jerk * dt per point, dt estimated from the previous speed; speed drops reset it.
+    double accel = 0.0;
+    for (size_t k = 1; k < count; k++) {
+        const size_t i = backward ? count - 1 - k : k;
+        const size_t prev = backward ? i + 1 : i - 1;
+        const double ds = std::fabs(distance[i] - distance[prev]);
+        const double v_prev = speed[prev];
+
+        double allowed = max_accel;
+        if (max_jerk > 0) {
+            const double dt = ds / std::max(v_prev, 1e-6);
+            allowed = std::min(max_accel, accel + max_jerk * dt);
+        }
+
+        const double reachable = std::sqrt(v_prev * v_prev + 2 * allowed * ds);
+        speed[i] = std::min(speed[i], reachable);
+        accel = ds > 0 ? std::max((speed[i] * speed[i] - v_prev * v_prev) / (2 * ds), 0.0) : accel;
+    }
+}
+
+template <typename T>
+void SpeedProfile::apply(T* path_data, size_t count, size_t columns, const Params& params,
+                         const std::vector<SpeedCap>& caps) {
+    if (count == 0) {
+        return;
+    }
+    std::vector<double> distance(count), curvature(count), speed(count);
+    for (size_t i = 0; i < count; i++) {
+        distance[i] = path_data[i * columns + kDistanceColumn];
+        curvature[i] = path_data[i * columns + kCurvatureColumn];
+    }
+
+    smoothCurvature(distance.data(), curvature.data(), count, params.window_size_cm, speed.data());
+    limitSpeeds(distance.data(), count, params, caps, speed.data());
+
+    speed[0] = params.min_speed;  // Start at min speed
+    accelerationPass(distance.data(), count, params.max_accel, params.max_jerk, false, speed.data());
+    speed[count - 1] = params.min_speed;  // End at min speed
+    accelerationPass(distance.data(), count, params.max_decel, params.max_jerk, true, speed.data());
+
+    for (size_t i = 0; i < count; i++) {
+        path_data[i * columns + kSpeedColumn] = (T)speed[i];
+    }
+}
+
+template void SpeedProfile::apply<float>(float*, size_t, size_t, const Params&, const std::vector<SpeedCap>&);
+template void SpeedProfile::apply<double>(double*, size_t, size_t, const Params&, const std::vector<SpeedCap>&);
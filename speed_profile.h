@@ -0,0 +1,53 @@
+#ifndef SPEED_PROFILE_H
+#define SPEED_PROFILE_H
+
+#include <cstddef>
+#include <vector>
+
+// Native counterparts of the per-point loops in speed_limit_calculator.py
+class SpeedProfile {
+public:
+    struct Params {
+        double max_speed;                // cm/s
+        double min_speed;                // cm/s, also the speed at both ends of the path
+        double max_turning_speed_rad_s;  // rad/s
+        double max_accel;                // cm/s^2
+        double max_decel;                // cm/s^2 (positive value)
+        double window_size_cm;           // curvature smoothing window
+        double max_jerk;                 // cm/s^3, 0 disables jerk limiting
+    };
+
+    // Upper speed bound for every point whose distance lies in [start_cm, end_cm]
+    struct SpeedCap {
+        double start_cm;
+        double end_cm;
+        double speed;
+    };
+
+    // Gaussian-weighted average of `curvature` over arc length: sigma = window / 4 and points
+    // further than window / 2 from the centre get no weight (same weights as
+    // calculate_speed_limits). `distance` must be non-decreasing. A sliding window keeps the
+    // cost at O(count * points per window). Throws std::invalid_argument for a negative or NaN
+    // window, also from apply().
+    static void smoothCurvature(const double* distance, const double* curvature, size_t count,
+                                double window_cm, double* out);
+
+    // Full speed limit profile: curvature limit, caps, then forward (acceleration) and
+    // backward (deceleration) passes. Reads curvature (degrees/cm) and distance from columns
+    // 2 and 4 of the row-major path_data buffer and writes the speed into column 5 in place.
+    template <typename T>
+    static void apply(T* path_data, size_t count, size_t columns, const Params& params,
+                      const std::vector<SpeedCap>& caps);
+
+    static constexpr size_t kCurvatureColumn = 2;
+    static constexpr size_t kDistanceColumn = 4;
+    static constexpr size_t kSpeedColumn = 5;
+
+private:
+    static void limitSpeeds(const double* distance, size_t count, const Params& params,
+                            const std::vector<SpeedCap>& caps, double* speed);
+    static void accelerationPass(const double* distance, size_t count, double max_accel, double max_jerk,
+                                 bool backward, double* speed);
+};
+
+#endif // SPEED_PROFILE_H
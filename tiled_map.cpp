@@ -0,0 +1,290 @@
+#include "tiled_map.h"
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstring>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+const char kMagic[4] = {'T', 'M', 'A', 'P'};
+const uint32_t kVersion = 1;
+
+struct FileHeader {
+    char magic[4];
+    uint32_t version;
+    int64_t rows;
+    int64_t cols;
+    uint32_t tile_size;
+    uint32_t reserved;
+    uint64_t index_offset;
+};
+static_assert(sizeof(FileHeader) == 40, "tiled map header must be packed");
+
+struct IndexEntry {
+    uint64_t offset;
+    uint32_t length;
+    uint32_t reserved;
+};
+static_assert(sizeof(IndexEntry) == 16, "tiled map index entries must be packed");
+
+// The header and index are copied to and from memory as-is
+bool littleEndian() {
+    const uint16_t probe = 1;
+    return *reinterpret_cast<const uint8_t*>(&probe) == 1;
+}
+
+void putVarint(std::vector<uint8_t>& out, uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back((uint8_t)(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back((uint8_t)value);
+}
+
+bool powerOfTwo(int64_t value) {
+    return value > 0 && (value & (value - 1)) == 0;
+}
+
+std::runtime_error ioError(const std::string& what, const std::string& path) {
+    return std::runtime_error(what + " " + path + ": " + std::strerror(errno));
+}
+
+}  // namespace
+
+TiledMap::TiledMap(const std::string& path, size_t cache_tiles) : cache_tiles_(cache_tiles) {
+    if (!littleEndian()) {
+        throw std::runtime_error("Tiled maps require a little-endian host");
+    }
+    const int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw ioError("Cannot open", path);
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || (size_t)info.st_size < sizeof(FileHeader)) {
+        ::close(fd);
+        throw std::runtime_error("Not a tiled map: " + path);
+    }
+    mapped_size_ = (size_t)info.st_size;
+    void* mapping = mmap(nullptr, mapped_size_, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        throw ioError("Cannot map", path);
+    }
+    mapping_ = static_cast<const uint8_t*>(mapping);
+
+    FileHeader header;
+    std::memcpy(&header, mapping_, sizeof(header));
+    rows_ = header.rows;
+    cols_ = header.cols;
+    tile_size_ = (int)header.tile_size;
+    const bool valid = std::memcmp(header.magic, kMagic, 4) == 0 && header.version == kVersion && rows_ > 0 &&
+                       cols_ > 0 && rows_ <= INT_MAX && cols_ <= INT_MAX && tile_size_ <= 4096 &&
+                       powerOfTwo(tile_size_);
+    if (valid) {
+        while ((1 << tile_shift_) < tile_size_) {
+            tile_shift_++;
+        }
+        tiles_x_ = (rows_ + tile_size_ - 1) / tile_size_;
+        tiles_y_ = (cols_ + tile_size_ - 1) / tile_size_;
+    }
+    const uint64_t index_size = (uint64_t)tiles_x_ * tiles_y_ * sizeof(IndexEntry);
+    if (!valid || header.index_offset > mapped_size_ || mapped_size_ - header.index_offset < index_size) {
+        munmap(mapping, mapped_size_);
+        throw std::runtime_error("Not a tiled map: " + path);
+    }
+    index_ = mapping_ + header.index_offset;
+}
+
+TiledMap::~TiledMap() {
+    munmap(const_cast<uint8_t*>(mapping_), mapped_size_);
+}
+
+size_t TiledMap::cachedTiles() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return lru_.size();
+}
+
+std::shared_ptr<const TiledMap::Tile> TiledMap::tile(int64_t id) const {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = cached_.find(id);
+        if (it != cached_.end()) {
+            lru_.splice(lru_.begin(), lru_, it->second);
+            return it->second->second;
+        }
+    }
+
+    // Decode outside the lock; two threads racing for one tile both decode it, harmlessly
+    IndexEntry entry;
+    std::memcpy(&entry, index_ + id * sizeof(IndexEntry), sizeof(entry));
+    if (entry.offset > mapped_size_ || mapped_size_ - entry.offset < entry.length) {
+        throw std::runtime_error("Corrupt tiled map: tile data out of range");
+    }
+    const size_t cells = (size_t)tile_size_ * tile_size_;
+    auto decoded = std::make_shared<Tile>(cells, 1);
+    const uint8_t* in = mapping_ + entry.offset;
+    const uint8_t* in_end = in + entry.length;
+    size_t cell = 0;
+    uint8_t value = 0;
+    while (in < in_end && cell < cells) {
+        uint64_t run = 0;
+        int shift = 0;
+        while (in < in_end) {
+            const uint8_t byte = *in++;
+            run |= (uint64_t)(byte & 0x7f) << shift;
+            shift += 7;
+            if (!(byte & 0x80)) {
+                break;
+            }
+        }
+        run = std::min<uint64_t>(run, cells - cell);
+        std::memset(decoded->data() + cell, value, run);
+        cell += run;
+        value ^= 1;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = cached_.find(id);
+    if (it != cached_.end()) {
+        return it->second->second;
+    }
+    lru_.emplace_front(id, decoded);
+    cached_[id] = lru_.begin();
+    while (lru_.size() > cache_tiles_) {
+        cached_.erase(lru_.back().first);
+        lru_.pop_back();
+    }
+    return decoded;
+}
+
+const TiledMap::Tile& TiledMap::View::pin(int64_t id) const {
+    auto it = pinned_.find(id);
+    if (it == pinned_.end()) {
+        it = pinned_.emplace(id, map_.tile(id)).first;
+    }
+    return *it->second;
+}
+
+TiledMap::Writer::Writer(const std::string& path, int64_t rows, int64_t cols, int tile_size)
+    : path_(path), rows_(rows), cols_(cols), tile_size_(tile_size), rows_written_(0), band_rows_(0),
+      file_(nullptr) {
+    if (!littleEndian()) {
+        throw std::runtime_error("Tiled maps require a little-endian host");
+    }
+    if (rows <= 0 || cols <= 0 || rows > INT_MAX || cols > INT_MAX) {
+        throw std::invalid_argument("Tiled map dimensions must be positive and fit in an int");
+    }
+    if (!powerOfTwo(tile_size) || tile_size > 4096) {
+        throw std::invalid_argument("Tile size must be a power of two up to 4096");
+    }
+    band_.assign((size_t)tile_size * cols, 1);
+    file_ = std::fopen(path.c_str(), "wb");
+    if (!file_) {
+        throw ioError("Cannot create", path);
+    }
+    // Placeholder header; close() fills in the index offset
+    FileHeader header = {};
+    if (std::fwrite(&header, sizeof(header), 1, file_) != 1) {
+        std::fclose(file_);
+        throw ioError("Cannot write", path);
+    }
+}
+
+TiledMap::Writer::~Writer() {
+    if (file_) {
+        // Not closed explicitly: the file is incomplete, leave it unreadable
+        std::fclose(file_);
+    }
+}
+
+void TiledMap::Writer::writeRows(const uint8_t* rows, size_t count) {
+    if (!file_) {
+        throw std::runtime_error("Tiled map writer is closed: " + path_);
+    }
+    if (rows_written_ + (int64_t)count > rows_) {
+        throw std::invalid_argument("More rows than the tiled map holds");
+    }
+    for (size_t i = 0; i < count; i++) {
+        const uint8_t* in = rows + i * cols_;
+        uint8_t* out = band_.data() + (size_t)band_rows_ * cols_;
+        for (int64_t y = 0; y < cols_; y++) {
+            out[y] = in[y] != 0;
+        }
+        rows_written_++;
+        if (++band_rows_ == tile_size_) {
+            flushBand();
+        }
+    }
+}
+
+void TiledMap::Writer::flushBand() {
+    // Rows below the map edge in the last band are blocked
+    std::fill(band_.begin() + (size_t)band_rows_ * cols_, band_.end(), 1);
+
+    const int64_t tiles_y = (cols_ + tile_size_ - 1) / tile_size_;
+    std::vector<uint8_t> encoded;
+    for (int64_t ty = 0; ty < tiles_y; ty++) {
+        encoded.clear();
+        uint8_t value = 0;
+        uint64_t run = 0;
+        for (int x = 0; x < tile_size_; x++) {
+            for (int k = 0; k < tile_size_; k++) {
+                const int64_t y = ty * tile_size_ + k;
+                const uint8_t cell = y < cols_ ? band_[(size_t)x * cols_ + y] : 1;
+                if (cell != value) {
+                    putVarint(encoded, run);
+                    value = cell;
+                    run = 0;
+                }
+                run++;
+            }
+        }
+        putVarint(encoded, run);
+
+        const long offset = std::ftell(file_);
+        if (offset < 0 || std::fwrite(encoded.data(), 1, encoded.size(), file_) != encoded.size()) {
+            throw ioError("Cannot write", path_);
+        }
+        offsets_.push_back((uint64_t)offset);
+        lengths_.push_back((uint32_t)encoded.size());
+    }
+    band_rows_ = 0;
+}
+
+void TiledMap::Writer::close() {
+    if (!file_) {
+        return;
+    }
+    if (rows_written_ != rows_) {
+        throw std::runtime_error("Tiled map " + path_ + " is missing rows: " + std::to_string(rows_written_) +
+                                 " of " + std::to_string(rows_) + " written");
+    }
+    if (band_rows_ > 0) {
+        flushBand();
+    }
+
+    FileHeader header = {};
+    std::memcpy(header.magic, kMagic, 4);
+    header.version = kVersion;
+    header.rows = rows_;
+    header.cols = cols_;
+    header.tile_size = (uint32_t)tile_size_;
+    const long index_offset = std::ftell(file_);
+    header.index_offset = (uint64_t)index_offset;
+    bool ok = index_offset >= 0;
+    for (size_t i = 0; ok && i < offsets_.size(); i++) {
+        const IndexEntry entry = {offsets_[i], lengths_[i], 0};
+        ok = std::fwrite(&entry, sizeof(entry), 1, file_) == 1;
+    }
+    ok = ok && std::fseek(file_, 0, SEEK_SET) == 0 && std::fwrite(&header, sizeof(header), 1, file_) == 1;
+    std::FILE* file = file_;
+    file_ = nullptr;
+    if (std::fclose(file) != 0 || !ok) {
+        throw ioError("Cannot write", path_);
+    }
+}
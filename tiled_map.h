@@ -0,0 +1,121 @@
+#ifndef TILED_MAP_H
+#define TILED_MAP_H
+
+#include <vector>
+#include <string>
+#include <memory>
+#include <mutex>
+#include <list>
+#include <unordered_map>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+
+// Occupancy maps too large for memory, stored as square tiles of run-length-encoded cells.
+// The file is memory-mapped, so compressed tiles are paged in by the OS on demand; decoded
+// tiles live in a bounded LRU cache. Searches read cells through a View, which pins every
+// tile it touches until the View is destroyed, so a query never sees a tile evicted under
+// it and repeated lookups skip the cache lock.
+//
+// File layout (little-endian):
+//   header  char[4] "TMAP", uint32 version, int64 rows, int64 cols, uint32 tile_size,
+//           uint32 reserved, uint64 index offset
+//   tiles   per tile, run lengths as LEB128 varints alternating free / blocked, free first,
+//           over tile_size * tile_size cells row-major (cells past the map edge are blocked)
+//   index   per tile, row-major over tiles: uint64 offset, uint32 length, uint32 reserved
+class TiledMap {
+public:
+    // Tile sizes must be powers of two. `cache_tiles` decoded tiles are kept beyond those pinned by live Views
+    explicit TiledMap(const std::string& path, size_t cache_tiles = 256);
+    ~TiledMap();
+
+    TiledMap(const TiledMap&) = delete;
+    TiledMap& operator=(const TiledMap&) = delete;
+
+    int64_t rows() const { return rows_; }
+    int64_t cols() const { return cols_; }
+    int tileSize() const { return tile_size_; }
+    size_t cachedTiles() const;
+
+    // Row-major tile_size * tile_size cells, nonzero = blocked
+    using Tile = std::vector<uint8_t>;
+
+    class View {
+    public:
+        explicit View(const TiledMap& map) : map_(map), last_id_(-1), last_(nullptr) {}
+
+        int rows() const { return (int)map_.rows_; }
+        int cols() const { return (int)map_.cols_; }
+
+        bool blocked(int x, int y) const {
+            const int shift = map_.tile_shift_;
+            const int mask = map_.tile_size_ - 1;
+            const int64_t id = (int64_t)(x >> shift) * map_.tiles_y_ + (y >> shift);
+            if (id != last_id_) {
+                last_ = &pin(id);
+                last_id_ = id;
+            }
+            return (*last_)[((size_t)(x & mask) << shift) + (y & mask)] != 0;
+        }
+
+        size_t pinnedTiles() const { return pinned_.size(); }
+
+    private:
+        const Tile& pin(int64_t id) const;
+
+        const TiledMap& map_;
+        mutable int64_t last_id_;
+        mutable const Tile* last_;
+        mutable std::unordered_map<int64_t, std::shared_ptr<const Tile>> pinned_;
+    };
+
+    // Builds a tiled map file from rows streamed top to bottom; only one band of tile rows
+    // is held in memory. Throws std::runtime_error on I/O errors.
+    class Writer {
+    public:
+        Writer(const std::string& path, int64_t rows, int64_t cols, int tile_size = 256);
+        ~Writer();
+
+        Writer(const Writer&) = delete;
+        Writer& operator=(const Writer&) = delete;
+
+        // `count` rows of `cols` cells each, nonzero = blocked
+        void writeRows(const uint8_t* rows, size_t count);
+        void close();
+
+        int64_t rowsWritten() const { return rows_written_; }
+        int64_t rows() const { return rows_; }
+        int64_t cols() const { return cols_; }
+
+    private:
+        void flushBand();
+
+        std::string path_;
+        int64_t rows_, cols_;
+        int tile_size_;
+        int64_t rows_written_;
+        std::vector<uint8_t> band_;  // tile_size rows of the map
+        int band_rows_;
+        std::vector<uint64_t> offsets_;
+        std::vector<uint32_t> lengths_;
+        std::FILE* file_;
+    };
+
+private:
+    std::shared_ptr<const Tile> tile(int64_t id) const;
+
+    int64_t rows_ = 0, cols_ = 0;
+    int tile_size_ = 0;
+    int tile_shift_ = 0;  // tile_size_ is a power of two
+    int64_t tiles_x_ = 0, tiles_y_ = 0;
+    size_t mapped_size_ = 0;
+    const uint8_t* mapping_ = nullptr;
+    const uint8_t* index_ = nullptr;
+
+    size_t cache_tiles_;
+    mutable std::mutex mutex_;
+    mutable std::list<std::pair<int64_t, std::shared_ptr<const Tile>>> lru_;  // most recent first
+    mutable std::unordered_map<int64_t, decltype(lru_)::iterator> cached_;
+};
+
+#endif // TILED_MAP_H
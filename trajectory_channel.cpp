@@ -0,0 +1,305 @@
+#include "trajectory_channel.h"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <thread>
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+const uint32_t kMagic = 0x4a415254;  // "TRAJ"
+const uint32_t kVersion = 3;
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "shared counters must be lock-free");
+static_assert(std::atomic<int32_t>::is_always_lock_free, "shared counters must be lock-free");
+
+// One row buffer; `sequence` is odd while the publisher is writing it
+struct alignas(64) BufferHeader {
+    std::atomic<uint64_t> sequence;
+    uint64_t generation;
+    uint64_t rows;
+};
+
+struct alignas(64) SegmentHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t max_rows;
+    uint64_t columns;
+    std::atomic<int32_t> publisher_pid;  // process publishing into the segment, 0 for none
+    std::atomic<uint32_t> retired;  // set once the name points to a new segment or none
+    std::atomic<uint64_t> generation;  // latest published; its buffer is generation & 1
+    BufferHeader buffers[2];
+};
+
+size_t bufferBytes(size_t max_rows, size_t columns) {
+    return max_rows * columns * sizeof(double);
+}
+
+size_t segmentBytes(size_t max_rows, size_t columns) {
+    return sizeof(SegmentHeader) + 2 * bufferBytes(max_rows, columns);
+}
+
+double* bufferRows(void* mapping, int buffer) {
+    const SegmentHeader* header = static_cast<const SegmentHeader*>(mapping);
+    return reinterpret_cast<double*>(static_cast<char*>(mapping) + sizeof(SegmentHeader)) +
+           buffer * header->max_rows * header->columns;
+}
+
+std::runtime_error systemError(const std::string& what, const std::string& name) {
+    return std::runtime_error(what + " '" + name + "': " + std::strerror(errno));
+}
+
+bool processAlive(int32_t pid) {
+    return pid > 0 && (kill(pid, 0) == 0 || errno == EPERM);
+}
+
+}  // namespace
+
+TrajectoryPublisher::TrajectoryPublisher(const std::string& name, size_t max_rows, size_t columns)
+    : name_(name), max_rows_(max_rows), columns_(columns), mapped_size_(segmentBytes(max_rows, columns)),
+      mapping_(nullptr) {
+    if (max_rows == 0 || columns == 0) {
+        throw std::invalid_argument("Trajectory capacity and columns must be positive");
+    }
+    // A new segment is sized and initialised here. An existing one is never truncated (that
+    // would fault subscribers still mapping it): with a matching layout it is taken over, with
+    // another layout it is retired and unlinked and a new one is created in its place.
+    const int32_t pid = (int32_t)getpid();
+    for (;;) {
+        int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+        if (fd >= 0) {
+            if (ftruncate(fd, (off_t)mapped_size_) != 0) {
+                close(fd);
+                shm_unlink(name.c_str());
+                throw systemError("Cannot size shared memory", name);
+            }
+            mapping_ = mmap(nullptr, mapped_size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+            close(fd);
+            if (mapping_ == MAP_FAILED) {
+                mapping_ = nullptr;
+                shm_unlink(name.c_str());
+                throw systemError("Cannot map shared memory", name);
+            }
+
+            // Fresh header: no trajectory yet. Readers validate magic last, so it is written last.
+            SegmentHeader* header = static_cast<SegmentHeader*>(mapping_);
+            header->magic = 0;
+            header->version = kVersion;
+            header->max_rows = max_rows;
+            header->columns = columns;
+            header->publisher_pid.store(pid, std::memory_order_relaxed);
+            header->retired.store(0, std::memory_order_relaxed);
+            header->generation.store(0, std::memory_order_relaxed);
+            for (BufferHeader& buffer : header->buffers) {
+                buffer.sequence.store(0, std::memory_order_relaxed);
+                buffer.generation = 0;
+                buffer.rows = 0;
+            }
+            std::atomic_thread_fence(std::memory_order_release);
+            header->magic = kMagic;
+            return;
+        }
+        if (errno != EEXIST) {
+            throw systemError("Cannot create shared memory", name);
+        }
+        fd = shm_open(name.c_str(), O_RDWR, 0);
+        if (fd < 0) {
+            if (errno == ENOENT) {
+                continue;  // unlinked since the create attempt
+            }
+            throw systemError("Cannot open shared memory", name);
+        }
+        struct stat info;
+        if (fstat(fd, &info) != 0 || (size_t)info.st_size < sizeof(SegmentHeader)) {
+            close(fd);
+            throw std::runtime_error("Shared memory '" + name + "' is not a trajectory channel");
+        }
+        const size_t existing_size = (size_t)info.st_size;
+        void* existing = mmap(nullptr, existing_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        close(fd);
+        if (existing == MAP_FAILED) {
+            throw systemError("Cannot map shared memory", name);
+        }
+
+        // The segment was left by a publisher that exited or crashed. It is claimed by swapping
+        // in this pid, so of two publishers starting together only one gets it.
+        SegmentHeader* header = static_cast<SegmentHeader*>(existing);
+        int32_t owner = header->publisher_pid.load(std::memory_order_acquire);
+        std::string problem;
+        if (header->magic != kMagic || header->version != kVersion) {
+            problem = "is not a trajectory channel";
+        } else if (processAlive(owner) || !header->publisher_pid.compare_exchange_strong(owner, pid)) {
+            problem = "already has a publisher";
+        }
+        if (!problem.empty()) {
+            munmap(existing, existing_size);
+            throw std::runtime_error("Shared memory '" + name + "' " + problem);
+        }
+        if (header->max_rows != max_rows || header->columns != columns || existing_size != mapped_size_) {
+            // Another layout: subscribers still attached see it retired and reopen by name
+            header->retired.store(1, std::memory_order_release);
+            munmap(existing, existing_size);
+            shm_unlink(name.c_str());
+            continue;
+        }
+
+        // Same layout: the trajectory and generation count carry on, so subscribers that stayed
+        // attached keep seeing generations increase. A publisher that died mid-write leaves that
+        // buffer's sequence odd; the buffer is not the published one, so closing the write lets
+        // readers and the next publish proceed.
+        mapping_ = existing;
+        for (BufferHeader& buffer : header->buffers) {
+            const uint64_t sequence = buffer.sequence.load(std::memory_order_relaxed);
+            if (sequence & 1) {
+                buffer.sequence.store(sequence + 1, std::memory_order_release);
+            }
+        }
+        return;
+    }
+}
+
+TrajectoryPublisher::~TrajectoryPublisher() {
+    // The segment stays so subscribers keep the last trajectory and the next publisher takes
+    // it over; remove() deletes it
+    if (mapping_) {
+        static_cast<SegmentHeader*>(mapping_)->publisher_pid.store(0, std::memory_order_release);
+        munmap(mapping_, mapped_size_);
+    }
+}
+
+void TrajectoryPublisher::remove(const std::string& name) {
+    const int fd = shm_open(name.c_str(), O_RDWR, 0);
+    if (fd < 0) {
+        if (errno == ENOENT) {
+            return;
+        }
+        throw systemError("Cannot open shared memory", name);
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || (size_t)info.st_size < sizeof(SegmentHeader)) {
+        close(fd);
+        throw std::runtime_error("Shared memory '" + name + "' is not a trajectory channel");
+    }
+    void* mapping = mmap(nullptr, sizeof(SegmentHeader), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        throw systemError("Cannot map shared memory", name);
+    }
+    SegmentHeader* header = static_cast<SegmentHeader*>(mapping);
+    std::string problem;
+    if (header->magic != kMagic || header->version != kVersion) {
+        problem = "is not a trajectory channel";
+    } else if (processAlive(header->publisher_pid.load(std::memory_order_acquire))) {
+        problem = "still has a publisher";
+    } else {
+        header->retired.store(1, std::memory_order_release);
+    }
+    munmap(mapping, sizeof(SegmentHeader));
+    if (!problem.empty()) {
+        throw std::runtime_error("Shared memory '" + name + "' " + problem);
+    }
+    shm_unlink(name.c_str());
+}
+
+uint64_t TrajectoryPublisher::publish(const double* rows, size_t count) {
+    if (count > max_rows_) {
+        throw std::invalid_argument("Trajectory has " + std::to_string(count) + " rows, channel holds " +
+                                    std::to_string(max_rows_));
+    }
+    SegmentHeader* header = static_cast<SegmentHeader*>(mapping_);
+    const uint64_t generation = header->generation.load(std::memory_order_relaxed) + 1;
+    const int index = (int)(generation & 1);
+    BufferHeader& buffer = header->buffers[index];
+
+    // Seqlock write: odd sequence, payload, even sequence
+    const uint64_t sequence = buffer.sequence.load(std::memory_order_relaxed);
+    buffer.sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    std::memcpy(bufferRows(mapping_, index), rows, count * columns_ * sizeof(double));
+    buffer.generation = generation;
+    buffer.rows = count;
+    buffer.sequence.store(sequence + 2, std::memory_order_release);
+
+    header->generation.store(generation, std::memory_order_release);
+    return generation;
+}
+
+TrajectorySubscriber::TrajectorySubscriber(const std::string& name)
+    : columns_(0), mapped_size_(0), mapping_(nullptr) {
+    const int fd = shm_open(name.c_str(), O_RDONLY, 0);
+    if (fd < 0) {
+        throw systemError("Cannot open shared memory", name);
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || (size_t)info.st_size < sizeof(SegmentHeader)) {
+        close(fd);
+        throw std::runtime_error("Shared memory '" + name + "' is not a trajectory channel");
+    }
+    mapped_size_ = (size_t)info.st_size;
+    mapping_ = mmap(nullptr, mapped_size_, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapping_ == MAP_FAILED) {
+        mapping_ = nullptr;
+        throw systemError("Cannot map shared memory", name);
+    }
+
+    const SegmentHeader* header = static_cast<const SegmentHeader*>(mapping_);
+    if (header->magic != kMagic || header->version != kVersion ||
+        mapped_size_ < segmentBytes(header->max_rows, header->columns)) {
+        munmap(mapping_, mapped_size_);
+        mapping_ = nullptr;
+        throw std::runtime_error("Shared memory '" + name + "' is not a trajectory channel");
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    columns_ = header->columns;
+}
+
+TrajectorySubscriber::~TrajectorySubscriber() {
+    if (mapping_) {
+        munmap(mapping_, mapped_size_);
+    }
+}
+
+bool TrajectorySubscriber::retired() const {
+    return static_cast<const SegmentHeader*>(mapping_)->retired.load(std::memory_order_acquire) != 0;
+}
+
+uint64_t TrajectorySubscriber::generation() const {
+    return static_cast<const SegmentHeader*>(mapping_)->generation.load(std::memory_order_acquire);
+}
+
+std::vector<double> TrajectorySubscriber::read(uint64_t& generation) const {
+    const SegmentHeader* header = static_cast<const SegmentHeader*>(mapping_);
+    std::vector<double> rows;
+    for (;;) {
+        const uint64_t latest = header->generation.load(std::memory_order_acquire);
+        if (latest == 0) {
+            generation = 0;
+            rows.clear();
+            return rows;
+        }
+        const int index = (int)(latest & 1);
+        const BufferHeader& buffer = header->buffers[index];
+
+        // Seqlock read: retry if the sequence was odd or moved while copying
+        const uint64_t before = buffer.sequence.load(std::memory_order_acquire);
+        if ((before & 1) == 0) {
+            const size_t count = std::min<uint64_t>(buffer.rows, header->max_rows);
+            const uint64_t copied = buffer.generation;
+            rows.resize(count * columns_);
+            std::memcpy(rows.data(), bufferRows(mapping_, index), rows.size() * sizeof(double));
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (buffer.sequence.load(std::memory_order_relaxed) == before) {
+                generation = copied;
+                return rows;
+            }
+        }
+        std::this_thread::yield();
+    }
+}
@@ -0,0 +1,76 @@
+#ifndef TRAJECTORY_CHANNEL_H
+#define TRAJECTORY_CHANNEL_H
+
+#include <vector>
+#include <string>
+#include <cstddef>
+#include <cstdint>
+
+// Trajectories (path_data_with_speeds rows) handed from the planner to the control process
+// through a POSIX shared-memory segment. The segment holds two row buffers, each guarded by a
+// sequence counter (seqlock): the publisher writes the buffer readers are not pointed at and
+// then flips the published generation, so a reader never blocks the publisher and never
+// observes a half-written path.
+class TrajectoryPublisher {
+public:
+    // Creates the segment `name` ("/planner_path") for up to `max_rows` rows of `columns`
+    // doubles. A segment left behind by a publisher that exited or crashed is taken over with
+    // its trajectory and generation count intact; one with another size is retired (see
+    // TrajectorySubscriber::retired) and replaced. Throws std::runtime_error when the segment
+    // is not a trajectory channel, its publisher is still running, or shared memory is
+    // unavailable.
+    TrajectoryPublisher(const std::string& name, size_t max_rows, size_t columns = 6);
+    // Leaves the segment in place for the next publisher
+    ~TrajectoryPublisher();
+
+    // Retires and unlinks the segment `name`; does nothing when it does not exist. Throws
+    // std::runtime_error while a publisher is still running on it.
+    static void remove(const std::string& name);
+
+    TrajectoryPublisher(const TrajectoryPublisher&) = delete;
+    TrajectoryPublisher& operator=(const TrajectoryPublisher&) = delete;
+
+    // Copies `count` rows in and makes them the current trajectory; returns its generation
+    uint64_t publish(const double* rows, size_t count);
+
+    size_t capacity() const { return max_rows_; }
+    size_t columns() const { return columns_; }
+
+private:
+    std::string name_;
+    size_t max_rows_;
+    size_t columns_;
+    size_t mapped_size_;
+    void* mapping_;
+};
+
+class TrajectorySubscriber {
+public:
+    // Attaches to an existing segment; throws std::runtime_error when it does not exist
+    explicit TrajectorySubscriber(const std::string& name);
+    ~TrajectorySubscriber();
+
+    TrajectorySubscriber(const TrajectorySubscriber&) = delete;
+    TrajectorySubscriber& operator=(const TrajectorySubscriber&) = delete;
+
+    // Generation of the latest published trajectory, 0 before the first publish. One atomic
+    // load, cheap enough to poll every control tick.
+    uint64_t generation() const;
+
+    // True once the segment was replaced or removed; no further trajectories arrive through
+    // it, and the channel has to be reopened by name
+    bool retired() const;
+
+    // Consistent copy of the latest trajectory as row-major doubles; `generation` receives
+    // the generation that was read. Retries while the publisher overwrites the buffer.
+    std::vector<double> read(uint64_t& generation) const;
+
+    size_t columns() const { return columns_; }
+
+private:
+    size_t columns_;
+    size_t mapped_size_;
+    void* mapping_;
+};
+
+#endif // TRAJECTORY_CHANNEL_H
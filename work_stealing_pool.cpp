@@ -0,0 +1,120 @@
+#include "work_stealing_pool.h"
+#include <algorithm>
+
+WorkStealingPool::WorkStealingPool(size_t threads) {
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    ranges_.reset(new Range[threads]);
+    workers_.reserve(threads);
+    for (size_t i = 0; i < threads; i++) {
+        workers_.emplace_back(&WorkStealingPool::workerLoop, this, i);
+    }
+}
+
+WorkStealingPool::~WorkStealingPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    start_.notify_all();
+    for (std::thread& worker : workers_) {
+        worker.join();
+    }
+}
+
+void WorkStealingPool::parallelFor(size_t count, const std::function<void(size_t, size_t)>& task) {
+    if (count == 0) {
+        return;
+    }
+    std::lock_guard<std::mutex> run_lock(run_mutex_);
+
+    // Equal contiguous shares to start with; stealing evens out the cost later
+    const size_t threads = size();
+    for (size_t i = 0; i < threads; i++) {
+        std::lock_guard<std::mutex> lock(ranges_[i].mutex);
+        ranges_[i].begin = count * i / threads;
+        ranges_[i].end = count * (i + 1) / threads;
+    }
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    task_ = &task;
+    finished_ = 0;
+    error_ = nullptr;
+    generation_++;
+    start_.notify_all();
+    done_.wait(lock, [&] { return finished_ == threads; });
+    task_ = nullptr;
+    if (error_) {
+        std::rethrow_exception(error_);
+    }
+}
+
+void WorkStealingPool::workerLoop(size_t worker) {
+    size_t seen = 0;
+    for (;;) {
+        const std::function<void(size_t, size_t)>* task;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            start_.wait(lock, [&] { return stopping_ || generation_ != seen; });
+            if (stopping_) {
+                return;
+            }
+            seen = generation_;
+            task = task_;
+        }
+
+        size_t index;
+        while (take(worker, index) || (steal(worker) && take(worker, index))) {
+            try {
+                (*task)(index, worker);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (!error_) {
+                    error_ = std::current_exception();
+                }
+            }
+        }
+
+        // No queue had work left; tasks still running elsewhere finish on their own threads
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (++finished_ == size()) {
+            done_.notify_one();
+        }
+    }
+}
+
+bool WorkStealingPool::take(size_t worker, size_t& index) {
+    Range& range = ranges_[worker];
+    std::lock_guard<std::mutex> lock(range.mutex);
+    if (range.begin >= range.end) {
+        return false;
+    }
+    index = range.begin++;
+    return true;
+}
+
+bool WorkStealingPool::steal(size_t worker) {
+    const size_t threads = size();
+    for (size_t k = 1; k < threads; k++) {
+        Range& victim = ranges_[(worker + k) % threads];
+        size_t begin, end;
+        {
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if (victim.begin >= victim.end) {
+                continue;
+            }
+            const size_t remaining = victim.end - victim.begin;
+            // The back half, or the last task if only one is left
+            begin = victim.end - (remaining + 1) / 2;
+            end = victim.end;
+            victim.end = begin;
+        }
+        Range& own = ranges_[worker];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        own.begin = begin;
+        own.end = end;
+        return true;
+    }
+    return false;
+}
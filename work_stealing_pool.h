@@ -0,0 +1,59 @@
+#ifndef WORK_STEALING_POOL_H
+#define WORK_STEALING_POOL_H
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <exception>
+#include <memory>
+#include <cstddef>
+
+// Persistent worker threads for parallel loops over tasks of very different cost. Each
+// worker starts with an equal contiguous range of task indices and runs it from the front;
+// a worker that runs dry steals the back half of another worker's remaining range, so slow
+// tasks never leave the other threads idle while work is queued behind them.
+class WorkStealingPool {
+public:
+    // `threads` workers; 0 uses one per hardware thread
+    explicit WorkStealingPool(size_t threads = 0);
+    ~WorkStealingPool();
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    size_t size() const { return workers_.size(); }
+
+    // Calls task(index, worker) for every index in [0, count) and returns once all are done.
+    // `worker` is in [0, size()) and identifies the calling thread, for per-worker state. The
+    // first exception thrown by a task is rethrown here after the remaining tasks finish.
+    // Concurrent calls run one after the other.
+    void parallelFor(size_t count, const std::function<void(size_t, size_t)>& task);
+
+private:
+    struct alignas(64) Range {
+        std::mutex mutex;
+        size_t begin = 0;
+        size_t end = 0;
+    };
+
+    void workerLoop(size_t worker);
+    bool take(size_t worker, size_t& index);
+    bool steal(size_t worker);
+
+    std::vector<std::thread> workers_;
+    std::unique_ptr<Range[]> ranges_;
+
+    std::mutex run_mutex_;  // serialises parallelFor calls
+    std::mutex mutex_;
+    std::condition_variable start_;
+    std::condition_variable done_;
+    const std::function<void(size_t, size_t)>* task_ = nullptr;
+    size_t generation_ = 0;
+    size_t finished_ = 0;
+    bool stopping_ = false;
+    std::exception_ptr error_;
+};
+
+#endif // WORK_STEALING_POOL_H